@@ -1,26 +1,49 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 
 static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
-//  replacer_ = new CLOCKReplacer(pool_size_);
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type,
+                                     bool huge_pages)
+    : pool_size_(pool_size),
+      target_pool_size_(pool_size),
+      frames_(huge_pages),
+      disk_manager_(disk_manager) {
+  frames_.Grow(pool_size_);
+  for (size_t i = 0; i < pool_size_; i++) {
+    pages_.emplace_back(frames_.GetFrame(i));
+  }
+  prefetched_.assign(pool_size_, false);
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      replacer_ = new CLOCKReplacer(pool_size_);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size_);
+      break;
+    default:
+      replacer_ = new LRUReplacer(pool_size_);
+  }
   for (size_t i = 0; i < pool_size_; i++) {
     free_list_.emplace_back(i);
   }
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page : page_table_) {
-    FlushPage(page.first);
+  StopWarmUp();
+  StopPrefetcher();
+  DisableBackgroundCleaner();
+  if (!page_table_.empty()) {
+    FlushAllPages();
   }
-  delete[] pages_;
   delete replacer_;
 }
 
@@ -29,106 +52,301 @@ BufferPoolManager::~BufferPoolManager() {
  */
 Page *BufferPoolManager::FetchPage(page_id_t page_id)  
 {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if (page_table_.count(page_id))                             //如果能够在buffer找到该页
   {
+    WaitForRead(page_table_[page_id]);                      //等待预读线程读完该页
+    prefetched_[page_table_[page_id]] = false;
+    hits_++;
     replacer_->Pin(page_table_[page_id]);                   //调用该页，将该页从DeleteList中删除
     pages_[page_table_[page_id]].pin_count_++;              //该页的pin_count加一
     return &(pages_[page_table_[page_id]]);                 //返回该页的指针
   }
   else                                                        //如果在buffer中找不到该页
   {
-    frame_id_t FreePageIndex;                             //声明变量，用于表示该页在buffer中的位置（下标）
-    if (free_list_.size() > 0)                              //如果free_list_中还有空位
-    {
-      FreePageIndex = free_list_.back();                //从free_list_中取出一个空位
-      free_list_.pop_back();                              //free_list空位数减一
-    }
-    else if (replacer_->Size() > 0)                         //如果lru_replacer中有可替换的页
-    {
-      frame_id_t *free_frame_receiver = new frame_id_t;   //用于接收replacer中的一个空位，因为要传一个指针到Victim函数中
-      replacer_->Victim(free_frame_receiver);             //从replacer中取出一个空位到free_frame_receiver中
-      FreePageIndex = *free_frame_receiver;             //将free_frame_receiver中的空位取出
-      delete free_frame_receiver;                         //释放内存空间
-    }
-    else                                                    //如果free_list没有空位且replacer中没有可被替换的页
+    frame_id_t FreePageIndex = TryToFindFreePage();         //从free_list_或replacer中取出一个空位
+    if (FreePageIndex == INVALID_FRAME_ID)                  //如果free_list没有空位且replacer中没有可被替换的页
     {
       return nullptr;
     }
-    if (pages_[FreePageIndex].is_dirty_)                  //如果该页是dirty的，就将该页写回disk
-    {
-      disk_manager_->WritePage(pages_[FreePageIndex].page_id_, pages_[FreePageIndex].data_);
-    }
-    page_table_.erase(pages_[FreePageIndex].page_id_);    //更新page_table_，将该页原先对应的那一条记录删除
-    pages_[FreePageIndex].ResetMemory();                  //将该页的data_清空
-    pages_[FreePageIndex].is_dirty_ = false;              //由于该页原先的数据已经被写回disk，所以将is_dirty_置为false
     pages_[FreePageIndex].page_id_ = page_id;             //更新该页对应的磁盘id
     page_table_[page_id] = FreePageIndex;                 //更新page_table_，将该页对应的那一条记录更新
-    disk_manager_->ReadPage(page_id, pages_[FreePageIndex].data_);    //从disk中读取该页的数据
+    WaitForCleaner(page_id);                              //等待后台清理线程写完该页
+    ReadPageFromDisk(page_id, pages_[FreePageIndex].data_);   //从disk中读取该页的数据
+    misses_++;
     replacer_->Pin(FreePageIndex);                        //引用该页，并将该页从DeleteList中删除
     pages_[FreePageIndex].pin_count_++;                   //该页的pin_count加一
     return &(pages_[FreePageIndex]);                      //返回该页的指针
   }
 }
 
+Page *BufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (strategy == nullptr) {
+    return FetchPage(page_id);
+  }
+  page_id_t ring_page_id;
+  Page *ring_page = strategy->GetCurrentBuffer(&ring_page_id);
+  // recycle the ring frame if it belongs to this pool, still holds the page the ring put there and nobody pins it
+  frame_id_t ring_frame_id = INVALID_FRAME_ID;
+  auto ring_iter = ring_page == nullptr ? page_table_.end() : page_table_.find(ring_page_id);
+  if (ring_iter != page_table_.end() && &pages_[ring_iter->second] == ring_page && ring_page->pin_count_ == 0) {
+    ring_frame_id = ring_iter->second;
+    WaitForRead(ring_frame_id);
+  }
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    // a page brought in by read-ahead for this scan joins the ring, and the ring gives one of its frames back
+    if (prefetched_[iter->second] && iter->second != ring_frame_id) {
+      if (ring_frame_id != INVALID_FRAME_ID) {
+        replacer_->Remove(ring_frame_id);
+        EvictFrame(ring_frame_id);
+        ReturnFrame(ring_frame_id);
+      }
+      strategy->AddBuffer(&pages_[iter->second], page_id);
+    }
+    return FetchPage(page_id);
+  }
+  frame_id_t frame_id = ring_frame_id;
+  if (frame_id != INVALID_FRAME_ID) {
+    replacer_->Remove(frame_id);
+    EvictFrame(frame_id);
+  } else {
+    frame_id = TryToFindFreePage();
+    if (frame_id == INVALID_FRAME_ID) {
+      return nullptr;
+    }
+  }
+  Page &page = pages_[frame_id];
+  page.page_id_ = page_id;
+  page_table_[page_id] = frame_id;
+  WaitForCleaner(page_id);
+  ReadPageFromDisk(page_id, page.data_);
+  misses_++;
+  replacer_->Pin(frame_id);
+  page.pin_count_++;
+  strategy->AddBuffer(&page, page_id);
+  return &page;
+}
+
 /**
  * TODO: Student Implement
  */
 Page *BufferPoolManager::NewPage(page_id_t &page_id) 
 {
-  frame_id_t FreePageIndex;
-  if (free_list_.size() > 0)                                  //如果free_list_中还有空位
-  {
-    FreePageIndex = free_list_.back();
-    free_list_.pop_back();
-  }
-  else if (replacer_->Size() > 0)                             //如果replacer中有可替换的页
-  {
-    frame_id_t *free_frame_receiver = new frame_id_t;
-    replacer_->Victim(free_frame_receiver);
-    FreePageIndex = *free_frame_receiver;
-    delete free_frame_receiver;
-  }
-  else
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t FreePageIndex = TryToFindFreePage();
+  if (FreePageIndex == INVALID_FRAME_ID)
   {
     return nullptr;
   }
-  if (pages_[FreePageIndex].is_dirty_)                      //如果该页是dirty的，就将该页写回disk
+  page_id = AllocatePage();                                   //在disk中分配一个新的页，得到一个新的page_id
+  if (page_id == INVALID_PAGE_ID)                             //disk中无法分配新页（如只读的数据库）
   {
-    disk_manager_->WritePage(pages_[FreePageIndex].page_id_, pages_[FreePageIndex].data_);
+    ReturnFrame(FreePageIndex);
+    return nullptr;
   }
-  page_table_.erase(pages_[FreePageIndex].page_id_);        //更新page_table_，将该页原先对应的那一条记录删除
-  page_id = AllocatePage();                                   //在disk中分配一个新的页，得到一个新的page_id
-  pages_[FreePageIndex].ResetMemory();                      //将该页的data_清空
-  pages_[FreePageIndex].is_dirty_ = false;                  //由于该页原先的数据已经被写回disk，所以将is_dirty_置为false
+  DropStaleFrame(page_id);                                  //丢弃该页号被释放前残留在buffer中的旧页
   pages_[FreePageIndex].page_id_ = page_id;                 //更新该页对应的磁盘id
   page_table_[page_id] = FreePageIndex;                     //更新page_table_，将该页对应的那一条记录更新
   replacer_->Pin(FreePageIndex);                            //引用该页，并将该页从DeleteList中删除
   pages_[FreePageIndex].pin_count_ = 1;                     //该页的pin_count置为1
+  new_pages_++;
   return &pages_[FreePageIndex];                            //返回该页的指针
 }
 
+page_id_t BufferPoolManager::NewPages(size_t count, const std::function<void(Page *)> &init) {
+  page_id_t first_page_id = disk_manager_->AllocatePages(count);
+  if (first_page_id == INVALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  for (size_t i = 0; i < count; i++) {
+    page_id_t page_id = first_page_id + static_cast<page_id_t>(i);
+    Page *page = NewPageWithId(page_id);
+    if (page == nullptr) {
+      // every frame is pinned, give the whole run back
+      for (size_t j = 0; j < count; j++) {
+        DeletePage(first_page_id + static_cast<page_id_t>(j));
+      }
+      return INVALID_PAGE_ID;
+    }
+    init(page);
+    UnpinPage(page_id, true);
+  }
+  return first_page_id;
+}
+
+Page *BufferPoolManager::NewPageWithId(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t frame_id = TryToFindFreePage();
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  DropStaleFrame(page_id);
+  pages_[frame_id].page_id_ = page_id;
+  page_table_[page_id] = frame_id;
+  replacer_->Pin(frame_id);
+  pages_[frame_id].pin_count_ = 1;
+  new_pages_++;
+  return &pages_[frame_id];
+}
+
+void BufferPoolManager::DropStaleFrame(page_id_t page_id) {
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return;
+  }
+  frame_id_t frame_id = iter->second;
+  WaitForRead(frame_id);
+  ASSERT(pages_[frame_id].pin_count_ == 0, "A page id is handed out again while its old page is pinned.");
+  replacer_->Remove(frame_id);
+  pages_[frame_id].ResetMemory();
+  pages_[frame_id].is_dirty_ = false;
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  prefetched_[frame_id] = false;
+  page_table_.erase(iter);
+  ReturnFrame(frame_id);
+}
+
+frame_id_t BufferPoolManager::TryToFindFreePage() {
+  frame_id_t frame_id;
+  if (!free_list_.empty()) {
+    frame_id = free_list_.back();
+    free_list_.pop_back();
+  } else if (!replacer_->Victim(&frame_id)) {
+    pin_waits_++;
+    return INVALID_FRAME_ID;
+  }
+  EvictFrame(frame_id);
+  return frame_id;
+}
+
+void BufferPoolManager::EvictFrame(frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  if (page.page_id_ != INVALID_PAGE_ID) {
+    evictions_++;
+  }
+  if (page.is_dirty_) {
+    WaitForCleaner(page.page_id_);
+    disk_manager_->WritePage(page.page_id_, page.data_);
+    foreground_writebacks_++;
+  }
+  auto iter = page_table_.find(page.page_id_);
+  if (iter != page_table_.end() && iter->second == frame_id) {
+    page_table_.erase(iter);
+  }
+  page.ResetMemory();
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.pin_count_ = 0;
+  prefetched_[frame_id] = false;
+}
+
+void BufferPoolManager::MakeEvictable(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) < target_pool_size_) {
+    replacer_->Unpin(frame_id);
+    return;
+  }
+  replacer_->Remove(frame_id);
+  EvictFrame(frame_id);
+  TrimFrames();
+}
+
+void BufferPoolManager::ReturnFrame(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) < target_pool_size_) {
+    free_list_.emplace_back(frame_id);
+    return;
+  }
+  TrimFrames();
+}
+
+void BufferPoolManager::TrimFrames() {
+  std::scoped_lock<std::mutex> reading_lock(reading_latch_);
+  while (pages_.size() > target_pool_size_) {
+    auto frame_id = static_cast<frame_id_t>(pages_.size() - 1);
+    Page &page = pages_.back();
+    if (page.page_id_ != INVALID_PAGE_ID || page.pin_count_ > 0 || reading_.count(frame_id) != 0) {
+      break;
+    }
+    pages_.pop_back();
+    prefetched_.pop_back();
+  }
+  frames_.Shrink(pages_.size());
+  pool_size_ = pages_.size();
+  replacer_->SetCapacity(pool_size_);
+}
+
+bool BufferPoolManager::Resize(size_t new_pool_size) {
+  if (new_pool_size == 0) {
+    return false;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  size_t old_pool_size = target_pool_size_;
+  target_pool_size_ = new_pool_size;
+  // empty frames of an earlier shrink that are kept after all
+  for (size_t i = old_pool_size; i < std::min(new_pool_size, pages_.size()); i++) {
+    if (pages_[i].page_id_ == INVALID_PAGE_ID) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+  }
+  if (new_pool_size >= pages_.size()) {
+    replacer_->SetCapacity(new_pool_size);
+    frames_.Grow(new_pool_size - pages_.size());
+    while (pages_.size() < new_pool_size) {
+      free_list_.emplace_back(static_cast<frame_id_t>(pages_.size()));
+      pages_.emplace_back(frames_.GetFrame(pages_.size()));
+      prefetched_.push_back(false);
+    }
+    pool_size_ = pages_.size();
+    return true;
+  }
+  free_list_.remove_if([new_pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= new_pool_size; });
+  for (size_t i = new_pool_size; i < pages_.size(); i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    if (pages_[i].page_id_ == INVALID_PAGE_ID || pages_[i].pin_count_ > 0) {
+      continue;
+    }
+    {
+      // a frame the I/O worker is reading into is evicted when the read completes
+      std::scoped_lock<std::mutex> reading_lock(reading_latch_);
+      if (reading_.count(frame_id) != 0) {
+        continue;
+      }
+    }
+    replacer_->Remove(frame_id);
+    EvictFrame(frame_id);
+  }
+  TrimFrames();
+  return true;
+}
+
 /**
  * TODO: Student Implement
  */
 bool BufferPoolManager::DeletePage(page_id_t page_id) 
 {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  WaitForCleaner(page_id);                                    //等待后台清理线程写完该页
   if (page_table_.count(page_id) == 0)                        //如果在buffer中找不到该页
   {
     DeallocatePage(page_id);                                //就直接在disk中删除该页
     return true;
   }
-  else if (pages_[page_table_[page_id]].pin_count_ > 0)       //如果该页被pin，则不能删除
+  WaitForRead(page_table_[page_id]);                          //等待预读线程读完该页
+  if (pages_[page_table_[page_id]].pin_count_ > 0)            //如果该页被pin，则不能删除
   {
     return false;
   }
   else                                                        //如果该页在buffer中且没有被pin
   {
-    replacer_->Pin(page_table_[page_id]);                   //利用pin将他从DeleteList中删除
+    replacer_->Remove(page_table_[page_id]);                //将他从replacer中删除
     DeallocatePage(page_id);                                //在disk中删除该页
     pages_[page_table_[page_id]].ResetMemory();             //将该页的data_清空
     pages_[page_table_[page_id]].is_dirty_ = false;         //由于该页被删除，所以将is_dirty_置为false
-    free_list_.emplace_back(page_table_[page_id]);          //由于该页被删除，所以将该空页的下标加入free_list_
+    pages_[page_table_[page_id]].page_id_ = INVALID_PAGE_ID;
+    frame_id_t frame_id = page_table_[page_id];
     page_table_.erase(page_id);                             //更新page_table_，将该页原先对应的那一条记录删除
+    ReturnFrame(frame_id);                                  //由于该页被删除，所以将该空页的下标加入free_list_
     return true;
   }
 }
@@ -138,12 +356,14 @@ bool BufferPoolManager::DeletePage(page_id_t page_id)
  */
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty)        
 {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if (page_table_.count(page_id) == 0) return false;                  //如果在buffer中找不到该页
+  if (pages_[page_table_[page_id]].pin_count_ <= 0) return false;     //该页没有被pin，不能再unpin
   pages_[page_table_[page_id]].pin_count_--;                          //如果找到该页，该页的pin_count减一
   pages_[page_table_[page_id]].is_dirty_ = pages_[page_table_[page_id]].is_dirty_ || is_dirty;    //如果该页原先是dirty的或者现在是dirty的，就将is_dirty_置为true
   if (pages_[page_table_[page_id]].pin_count_ == 0)                   //如果该页的pin_count为0，说明现在该页不被引用，就将该页放到DeleteList中
   {
-    replacer_->Unpin(page_table_[page_id]);
+    MakeEvictable(page_table_[page_id]);
   }
   return true;
 }
@@ -153,12 +373,465 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty)
  */
 bool BufferPoolManager::FlushPage(page_id_t page_id) 
 {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   if (page_table_.count(page_id) == 0) return false;                      //如果在buffer中找不到该页
+  WaitForRead(page_table_[page_id]);                                      //等待预读线程读完该页
+  WaitForCleaner(page_id);                                                //等待后台清理线程写完该页
   disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].data_);  //如果该页在buffer中，则将该页的数据写回disk
   pages_[page_table_[page_id]].is_dirty_ = false;                         //由于已经写回disk，所以将is_dirty_置为false
   return true;
 }
 
+size_t BufferPoolManager::FlushAllPages() {
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    CollectDirtyPages(&pages);
+    disk_manager_->WritePages(pages);
+  }
+  disk_manager_->Sync();
+  return pages.size();
+}
+
+void BufferPoolManager::CollectDirtyPages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  for (auto &entry : page_table_) {
+    Page &page = pages_[entry.second];
+    if (!page.is_dirty_) {
+      continue;
+    }
+    WaitForCleaner(entry.first);
+    page.is_dirty_ = false;
+    pages->emplace_back(entry.first, page.data_);
+  }
+}
+
+void BufferPoolManager::EnableBackgroundCleaner(double clean_fraction, std::chrono::milliseconds interval) {
+  DisableBackgroundCleaner();
+  clean_fraction_ = clean_fraction;
+  cleaner_running_ = true;
+  cleaner_ = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> lock(cleaner_latch_);
+    while (!cleaner_cv_.wait_for(lock, interval, [this]() { return !cleaner_running_; })) {
+      lock.unlock();
+      CleanVictims();
+      lock.lock();
+    }
+  });
+}
+
+void BufferPoolManager::DisableBackgroundCleaner() {
+  {
+    std::scoped_lock<std::mutex> lock(cleaner_latch_);
+    cleaner_running_ = false;
+  }
+  cleaner_cv_.notify_all();
+  if (cleaner_.joinable()) {
+    cleaner_.join();
+  }
+}
+
+void BufferPoolManager::WaitForCleaner(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(cleaning_latch_);
+  if (cleaning_.count(page_id) != 0) {
+    pin_waits_++;
+    cleaning_cv_.wait(lock, [this, page_id]() { return cleaning_.count(page_id) == 0; });
+  }
+}
+
+void BufferPoolManager::CleanVictims() {
+  std::vector<std::pair<page_id_t, size_t>> batch;  // page id and its slot in cleaner_buffer_
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    std::vector<frame_id_t> candidates;
+    replacer_->GetVictimCandidates(static_cast<size_t>(clean_fraction_ * pool_size_), &candidates);
+    if (cleaner_buffer_.GetSize() < candidates.size()) {
+      cleaner_buffer_.Grow(candidates.size() - cleaner_buffer_.GetSize());
+    }
+    std::scoped_lock<std::mutex> cleaning_lock(cleaning_latch_);
+    for (auto frame_id : candidates) {
+      Page &page = pages_[frame_id];
+      if (!page.is_dirty_ || page.pin_count_ > 0) {
+        continue;
+      }
+      // the page is unpinned, so nobody modifies it while we copy it; a later modification marks it dirty again
+      memcpy(cleaner_buffer_.GetFrame(batch.size()), page.data_, PAGE_SIZE);
+      page.is_dirty_ = false;
+      cleaning_.insert(page.page_id_);
+      batch.emplace_back(page.page_id_, batch.size());
+    }
+  }
+  if (batch.empty()) {
+    return;
+  }
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (auto &entry : batch) {
+    pages.emplace_back(entry.first, cleaner_buffer_.GetFrame(entry.second));
+  }
+  disk_manager_->WritePages(std::move(pages));
+  background_writebacks_ += batch.size();
+  {
+    std::scoped_lock<std::mutex> cleaning_lock(cleaning_latch_);
+    cleaning_.clear();
+  }
+  cleaning_cv_.notify_all();
+}
+
+void BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  EnqueuePrefetch(page_id, 1, 0);
+}
+
+void BufferPoolManager::PrefetchRange(page_id_t first_page_id, size_t count) {
+  EnqueuePrefetch(first_page_id, count, 0);
+}
+
+void BufferPoolManager::PrefetchChain(page_id_t page_id, size_t count, size_t next_page_id_offset) {
+  EnqueuePrefetch(page_id, count, next_page_id_offset);
+}
+
+void BufferPoolManager::EnqueuePrefetch(page_id_t page_id, size_t count, size_t next_page_id_offset) {
+  static constexpr size_t MAX_PENDING_PREFETCH = 64;
+  if (page_id == INVALID_PAGE_ID || count == 0) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_latch_);
+    if (!prefetcher_running_) {
+      prefetcher_running_ = true;
+      prefetcher_ = std::thread(&BufferPoolManager::PrefetchWorker, this);
+    }
+    // read-ahead is only a hint, drop it when the worker falls behind
+    if (prefetch_queue_.size() >= MAX_PENDING_PREFETCH) {
+      return;
+    }
+    prefetch_queue_.push_back({page_id, count, next_page_id_offset});
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManager::StopPrefetcher() {
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_latch_);
+    prefetcher_running_ = false;
+    prefetch_queue_.clear();
+  }
+  prefetch_cv_.notify_all();
+  if (prefetcher_.joinable()) {
+    prefetcher_.join();
+  }
+}
+
+void BufferPoolManager::PrefetchWorker() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this]() { return !prefetcher_running_ || !prefetch_queue_.empty(); });
+    if (!prefetcher_running_) {
+      return;
+    }
+    PrefetchRequest request = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    page_id_t page_id = request.page_id_;
+    if (request.next_page_id_offset_ == 0) {
+      ReadAheadRange(page_id, request.count_);
+      lock.lock();
+      continue;
+    }
+    // B+ tree leaves end their chain with 0, which is never a heap or leaf page since it holds the catalog meta
+    for (size_t i = 0; i < request.count_ && page_id != INVALID_PAGE_ID && page_id != CATALOG_META_PAGE_ID; i++) {
+      page_id = ReadAhead(page_id, request.next_page_id_offset_);
+    }
+    lock.lock();
+  }
+}
+
+page_id_t BufferPoolManager::ReadAhead(page_id_t page_id, size_t next_page_id_offset) {
+  frame_id_t frame_id;
+  Page *page;
+  bool resident;
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    auto iter = page_table_.find(page_id);
+    resident = iter != page_table_.end();
+    if (resident && next_page_id_offset == 0) {
+      return INVALID_PAGE_ID;
+    }
+    if (!resident) {
+      frame_id = ReserveReadAhead(page_id, &page);
+      if (frame_id == INVALID_FRAME_ID) {
+        return INVALID_PAGE_ID;
+      }
+    } else {
+      // already resident, only the next page id of the chain is needed; pin the page so it stays while it is latched
+      frame_id = iter->second;
+      WaitForRead(frame_id);
+      page = &pages_[frame_id];
+      replacer_->Pin(frame_id);
+      page->pin_count_++;
+    }
+  }
+  if (resident) {
+    // the next page id is only stable under the page latch, the page may be written concurrently
+    page->RLatch();
+    page_id_t next_page_id = *reinterpret_cast<page_id_t *>(page->data_ + next_page_id_offset);
+    page->RUnlatch();
+    UnpinPage(page_id, false);
+    return next_page_id;
+  }
+  // the frame is not published until FinishRead, nobody else can latch or write it
+  ReadPageFromDisk(page_id, page->data_);
+  page_id_t next_page_id = next_page_id_offset == 0
+                               ? INVALID_PAGE_ID
+                               : *reinterpret_cast<page_id_t *>(page->data_ + next_page_id_offset);
+  FinishRead(page_id, frame_id);
+  return next_page_id;
+}
+
+frame_id_t BufferPoolManager::ReserveReadAhead(page_id_t page_id, Page **page, bool *busy) {
+  std::unique_lock<std::recursive_mutex> lock(latch_, std::defer_lock);
+  if (busy == nullptr) {
+    lock.lock();
+  } else if (!lock.try_lock()) {
+    *busy = true;
+    return INVALID_FRAME_ID;
+  }
+  if (page_table_.count(page_id) != 0 || disk_manager_->IsPageFree(page_id)) {
+    return INVALID_FRAME_ID;
+  }
+  frame_id_t frame_id = TryToFindFreePage();
+  if (frame_id == INVALID_FRAME_ID) {
+    return INVALID_FRAME_ID;
+  }
+  *page = &pages_[frame_id];
+  (*page)->page_id_ = page_id;
+  page_table_[page_id] = frame_id;
+  prefetched_[frame_id] = true;
+  // the frame is neither pinned nor in the replacer, nobody else touches it until it leaves reading_
+  WaitForCleaner(page_id);
+  std::scoped_lock<std::mutex> reading_lock(reading_latch_);
+  reading_.insert(frame_id);
+  return frame_id;
+}
+
+void BufferPoolManager::ReadAheadRange(page_id_t first_page_id, size_t count) {
+  std::vector<std::pair<page_id_t, frame_id_t>> reads;
+  std::vector<PageIORequest> requests;
+  IOBatch batch;
+  size_t i = 0;
+  while (i < count) {
+    reads.clear();
+    requests.clear();
+    for (; i < count; i++) {
+      // like the warm-up, never wait for the latch while holding reserved frames
+      bool busy = false;
+      Page *page;
+      frame_id_t frame_id =
+          ReserveReadAhead(first_page_id + static_cast<page_id_t>(i), &page, reads.empty() ? nullptr : &busy);
+      if (busy) {
+        break;
+      }
+      if (frame_id != INVALID_FRAME_ID) {
+        reads.emplace_back(page->page_id_, frame_id);
+        requests.push_back({page->page_id_, page->data_, false, [&batch]() { batch.Done(); }});
+      }
+    }
+    if (reads.empty()) {
+      continue;
+    }
+    disk_reads_ += reads.size();
+    batch.Add(requests.size());
+    disk_manager_->SubmitPageIO(std::move(requests));
+    // wait for these reads only, a concurrent write-back keeps the engine busy for longer
+    batch.Wait();
+    FinishReads(reads);
+  }
+}
+
+frame_id_t BufferPoolManager::ReserveFrame(page_id_t page_id, Page **page, bool *pool_full, bool *busy) {
+  std::unique_lock<std::recursive_mutex> lock(latch_, std::defer_lock);
+  if (busy == nullptr) {
+    lock.lock();
+  } else if (!lock.try_lock()) {
+    *busy = true;
+    return INVALID_FRAME_ID;
+  }
+  if (page_table_.count(page_id) != 0) {
+    return INVALID_FRAME_ID;
+  }
+  if (free_list_.empty()) {
+    *pool_full = true;
+    return INVALID_FRAME_ID;
+  }
+  frame_id_t frame_id = free_list_.back();
+  free_list_.pop_back();
+  *page = &pages_[frame_id];
+  (*page)->page_id_ = page_id;
+  page_table_[page_id] = frame_id;
+  WaitForCleaner(page_id);
+  std::scoped_lock<std::mutex> reading_lock(reading_latch_);
+  reading_.insert(frame_id);
+  return frame_id;
+}
+
+void BufferPoolManager::FinishReads(const std::vector<std::pair<page_id_t, frame_id_t>> &reads) {
+  // leave reading_ before taking the latch, a fetch of any of the pages holds the latch while it waits for the read
+  {
+    std::scoped_lock<std::mutex> reading_lock(reading_latch_);
+    for (auto &read : reads) {
+      reading_.erase(read.second);
+    }
+  }
+  reading_cv_.notify_all();
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  for (auto &[page_id, frame_id] : reads) {
+    if (pages_[frame_id].page_id_ == page_id && pages_[frame_id].pin_count_ == 0) {
+      MakeEvictable(frame_id);
+    }
+  }
+}
+
+void BufferPoolManager::GetResidentPages(std::vector<page_id_t> *page_ids) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  // pinned pages are in use right now, the evictable ones follow from the most to the least recently used
+  for (auto &page : pages_) {
+    if (page.page_id_ != INVALID_PAGE_ID && page.pin_count_ > 0) {
+      page_ids->push_back(page.page_id_);
+    }
+  }
+  std::vector<frame_id_t> candidates;
+  replacer_->GetVictimCandidates(pages_.size(), &candidates);
+  for (auto iter = candidates.rbegin(); iter != candidates.rend(); ++iter) {
+    if (pages_[*iter].page_id_ != INVALID_PAGE_ID) {
+      page_ids->push_back(pages_[*iter].page_id_);
+    }
+  }
+}
+
+bool BufferPoolManager::DumpResidentPages(const std::string &file_name) {
+  std::vector<page_id_t> page_ids;
+  GetResidentPages(&page_ids);
+  // write a temporary file first, so that a crash never leaves a truncated list behind
+  std::string temp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out(temp_file_name, std::ios::trunc);
+    for (auto page_id : page_ids) {
+      out << page_id << '\n';
+    }
+    if (!out.good()) {
+      LOG(WARNING) << "Failed to write resident page list " << temp_file_name;
+      return false;
+    }
+  }
+  return std::rename(temp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+void BufferPoolManager::WarmUp(const std::string &file_name) {
+  std::vector<page_id_t> page_ids;
+  std::ifstream in(file_name);
+  page_id_t page_id;
+  while (page_ids.size() < GetPoolSize() && in >> page_id) {
+    if (page_id >= 0) {
+      page_ids.push_back(page_id);
+    }
+  }
+  if (page_ids.empty()) {
+    return;
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  StopWarmUp();
+  warm_up_running_ = true;
+  warmer_ = std::thread(&BufferPoolManager::WarmUpWorker, this, std::move(page_ids));
+}
+
+void BufferPoolManager::WaitForWarmUp() {
+  if (warmer_.joinable()) {
+    warmer_.join();
+  }
+}
+
+void BufferPoolManager::StopWarmUp() {
+  warm_up_running_ = false;
+  WaitForWarmUp();
+}
+
+void BufferPoolManager::WarmUpWorker(std::vector<page_id_t> page_ids) {
+  // a single chunk, so the pages of a run are contiguous
+  FrameArena buffer;
+  buffer.Grow(DEFAULT_WARM_UP_READ_PAGES);
+  std::vector<std::pair<Page *, frame_id_t>> frames;
+  std::vector<std::pair<page_id_t, frame_id_t>> reads;
+  bool pool_full = false;
+  size_t begin = 0;
+  while (begin < page_ids.size() && !pool_full && warm_up_running_) {
+    size_t end = begin + 1;
+    while (end < page_ids.size() && end - begin < static_cast<size_t>(DEFAULT_WARM_UP_READ_PAGES) &&
+           page_ids[end] == page_ids[end - 1] + 1) {
+      end++;
+    }
+    frames.assign(end - begin, {nullptr, INVALID_FRAME_ID});
+    bool reserved = false;
+    for (size_t i = begin; i < end && !pool_full; i++) {
+      // the list may be older than the last page deallocations
+      if (IsPageFree(page_ids[i])) {
+        continue;
+      }
+      // once a frame of the batch is reserved, a busy latch cuts the batch short instead of waiting for it
+      bool busy = false;
+      frames[i - begin].second =
+          ReserveFrame(page_ids[i], &frames[i - begin].first, &pool_full, reserved ? &busy : nullptr);
+      if (busy) {
+        end = i;
+        break;
+      }
+      reserved = reserved || frames[i - begin].second != INVALID_FRAME_ID;
+    }
+    if (reserved) {
+      disk_manager_->ReadPages(page_ids[begin], end - begin, buffer.GetFrame(0));
+      reads.clear();
+      for (size_t i = begin; i < end; i++) {
+        if (frames[i - begin].second != INVALID_FRAME_ID) {
+          memcpy(frames[i - begin].first->data_, buffer.GetFrame(i - begin), PAGE_SIZE);
+          reads.emplace_back(page_ids[i], frames[i - begin].second);
+        }
+      }
+      FinishReads(reads);
+    }
+    begin = end;
+  }
+}
+
+void BufferPoolManager::WaitForRead(frame_id_t frame_id) {
+  std::unique_lock<std::mutex> lock(reading_latch_);
+  if (reading_.count(frame_id) != 0) {
+    pin_waits_++;
+    reading_cv_.wait(lock, [this, frame_id]() { return reading_.count(frame_id) == 0; });
+  }
+}
+
+void BufferPoolManager::ReadPageFromDisk(page_id_t page_id, char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->ReadPage(page_id, page_data);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  disk_reads_++;
+  disk_read_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+BufferPoolStats BufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  stats.pool_size_ = pool_size_;
+  stats.hits_ = hits_;
+  stats.misses_ = misses_;
+  stats.evictions_ = evictions_;
+  stats.foreground_writebacks_ = foreground_writebacks_;
+  stats.background_writebacks_ = background_writebacks_;
+  stats.new_pages_ = new_pages_;
+  stats.deleted_pages_ = deleted_pages_;
+  stats.pin_waits_ = pin_waits_;
+  stats.disk_reads_ = disk_reads_;
+  stats.disk_read_time_us_ = disk_read_time_us_;
+  return stats;
+}
+
 page_id_t BufferPoolManager::AllocatePage() {
   int next_page_id = disk_manager_->AllocatePage();
   return next_page_id;
@@ -166,6 +839,7 @@ page_id_t BufferPoolManager::AllocatePage() {
 
 void BufferPoolManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {
   disk_manager_->DeAllocatePage(page_id);
+  deleted_pages_++;
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
@@ -174,6 +848,7 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -59,6 +59,24 @@ void CLOCKReplacer::Unpin(frame_id_t frame_id) {
   SecondChance[frame_id % capacity] = State::ACCESSED;
 }
 
+void CLOCKReplacer::GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) {
+  // frames without a second chance go first, then the ones the hand would reset on its first sweep
+  for (auto state : {State::UNUSED, State::ACCESSED}) {
+    for (size_t i = 0; i < capacity && frames->size() < num; i++) {
+      auto id = (pointer + i) % capacity;
+      if (SecondChance[id] == state) {
+        frames->push_back(id);
+      }
+    }
+  }
+}
+
+void CLOCKReplacer::SetCapacity(size_t num_pages) {
+  SecondChance.resize(num_pages, State::EMPTY);
+  capacity = num_pages;
+  pointer = capacity == 0 ? 0 : pointer % capacity;
+}
+
 /**
  * @breif count those State != EMPTY
  * @return the current size of replacer
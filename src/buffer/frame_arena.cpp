@@ -0,0 +1,76 @@
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "glog/logging.h"
+
+FrameArena::~FrameArena() { Shrink(0); }
+
+void FrameArena::Grow(size_t count) {
+  if (!chunks_.empty()) {
+    const Chunk &last = chunks_.back();
+    size_t reused = std::min(count, last.first_frame_ + last.frames_ - size_);
+    // frames given back by Shrink may still hold the data of evicted pages
+    memset(GetFrame(size_), 0, reused * PAGE_SIZE);
+    size_ += reused;
+    count -= reused;
+  }
+  if (count == 0) {
+    return;
+  }
+  size_t bytes = count * PAGE_SIZE;
+  size_t alignment = huge_pages_ ? HUGE_PAGE_SIZE : PAGE_SIZE;
+  bytes = (bytes + alignment - 1) / alignment * alignment;
+  // anonymous memory is zeroed and page aligned, for huge pages map a bit more and cut it down to an aligned range
+  size_t mapped_bytes = huge_pages_ ? bytes + HUGE_PAGE_SIZE : bytes;
+  void *mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  char *data = static_cast<char *>(mapping);
+  if (huge_pages_) {
+    auto address = reinterpret_cast<uintptr_t>(mapping);
+    size_t head = (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    if (head > 0) {
+      munmap(data, head);
+    }
+    if (mapped_bytes - head > bytes) {
+      munmap(data + head + bytes, mapped_bytes - head - bytes);
+    }
+    data += head;
+    if (madvise(data, bytes, MADV_HUGEPAGE) != 0) {
+      LOG(WARNING) << "Transparent huge pages are not available for the buffer pool";
+    }
+  }
+  const size_t first_frame = chunks_.empty() ? 0 : chunks_.back().first_frame_ + chunks_.back().frames_;
+  chunks_.push_back({first_frame, bytes / PAGE_SIZE, data, bytes});
+  size_ += count;
+}
+
+void FrameArena::Shrink(size_t count) {
+  size_ = std::min(size_, count);
+  while (!chunks_.empty() && chunks_.back().first_frame_ >= size_) {
+    munmap(chunks_.back().data_, chunks_.back().bytes_);
+    chunks_.pop_back();
+  }
+}
+
+char *FrameArena::GetFrame(size_t index) const {
+  // the last chunk whose first frame is not beyond index
+  auto iter = std::upper_bound(chunks_.begin(), chunks_.end(), index,
+                               [](size_t frame, const Chunk &chunk) { return frame < chunk.first_frame_; });
+  const Chunk &chunk = *(iter - 1);
+  return chunk.data_ + (index - chunk.first_frame_) * PAGE_SIZE;
+}
+
+size_t FrameArena::GetMappedBytes() const {
+  size_t bytes = 0;
+  for (auto &chunk : chunks_) {
+    bytes += chunk.bytes_;
+  }
+  return bytes;
+}
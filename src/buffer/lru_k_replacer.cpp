@@ -0,0 +1,98 @@
+#include "buffer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, uint64_t correlated_period)
+    : k_(k), correlated_period_(correlated_period) {
+  frames_.reserve(num_pages);
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  if (Size() == 0) {
+    return false;
+  }
+  // prefer a frame that is out of its correlated reference period, infinite distances first
+  for (auto *candidates : {&infinite_, &finite_}) {
+    for (auto &entry : *candidates) {
+      if (current_time_ - frames_[entry.second].last_ > correlated_period_) {
+        *frame_id = entry.second;
+        Remove(entry.second);
+        return true;
+      }
+    }
+  }
+  // every candidate was referenced recently, fall back to the plain LRU-K order
+  *frame_id = infinite_.empty() ? finite_.begin()->second : infinite_.begin()->second;
+  Remove(*frame_id);
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  auto &history = frames_[frame_id];
+  if (history.evictable_) {
+    CandidateSet(history).erase({EvictionKey(history), frame_id});
+    history.evictable_ = false;
+  }
+  RecordAccess(history);
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  auto &history = frames_[frame_id];
+  if (history.evictable_) {
+    return;
+  }
+  if (history.hist_.empty()) {
+    RecordAccess(history);
+  }
+  history.evictable_ = true;
+  CandidateSet(history).emplace(EvictionKey(history), frame_id);
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    return;
+  }
+  if (iter->second.evictable_) {
+    CandidateSet(iter->second).erase({EvictionKey(iter->second), frame_id});
+  }
+  frames_.erase(iter);
+}
+
+void LRUKReplacer::GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) {
+  for (auto *candidates : {&infinite_, &finite_}) {
+    for (auto iter = candidates->begin(); iter != candidates->end() && frames->size() < num; ++iter) {
+      frames->push_back(iter->second);
+    }
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  return infinite_.size() + finite_.size();
+}
+
+void LRUKReplacer::RecordAccess(FrameHistory &history) {
+  uint64_t now = ++current_time_;
+  if (history.hist_.empty()) {
+    history.hist_.push_front(now);
+  } else if (now - history.last_ > correlated_period_) {
+    // a new uncorrelated reference: the previous correlated period collapses into a single point in time
+    uint64_t correlated = history.last_ - history.hist_.front();
+    for (auto &time : history.hist_) {
+      time += correlated;
+    }
+    history.hist_.push_front(now);
+    if (history.hist_.size() > k_) {
+      history.hist_.pop_back();
+    }
+  }
+  history.last_ = now;
+}
+
+uint64_t LRUKReplacer::EvictionKey(const FrameHistory &history) const {
+  return history.hist_.size() < k_ ? history.last_ : history.hist_.back();
+}
+
+std::set<std::pair<uint64_t, frame_id_t>> &LRUKReplacer::CandidateSet(const FrameHistory &history) {
+  return history.hist_.size() < k_ ? infinite_ : finite_;
+}
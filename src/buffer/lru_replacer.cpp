@@ -43,6 +43,14 @@ void LRUReplacer::Unpin(frame_id_t frame_id)
   Map[frame_id] = DeleteList.begin(); //把这个frame_id放到哈希表中
 }
 
+void LRUReplacer::GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames)
+{
+    for (auto iter = DeleteList.rbegin(); iter != DeleteList.rend() && frames->size() < num; ++iter)
+    {
+        frames->push_back(*iter);//从链表尾部（最久未使用）开始
+    }
+}
+
 /**
  * TODO: Student Implement
  */
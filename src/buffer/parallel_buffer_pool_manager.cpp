@@ -0,0 +1,187 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "glog/logging.h"
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type,
+                                                     bool huge_pages)
+    : BufferPoolManager(disk_manager), num_instances_(num_instances), disk_manager_(disk_manager) {
+  ASSERT(num_instances_ > 0, "Buffer pool needs at least one instance.");
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_.emplace_back(new BufferPoolManager(pool_size, disk_manager_, replacer_type, huge_pages));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // the I/O worker and the warm-up thread read through the instances
+  StopWarmUp();
+  StopPrefetcher();
+  // one sorted batch over all instances instead of a write per page
+  FlushAllPages();
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+size_t ParallelBufferPoolManager::FlushAllPages() {
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  {
+    // the pages of all instances are interleaved in the file, so they are written as one batch
+    std::vector<std::unique_lock<std::recursive_mutex>> locks;
+    for (auto instance : instances_) {
+      locks.emplace_back(instance->latch_);
+      instance->CollectDirtyPages(&pages);
+    }
+    disk_manager_->WritePages(pages);
+  }
+  disk_manager_->Sync();
+  return pages.size();
+}
+
+Page *ParallelBufferPoolManager::NewPage(page_id_t &page_id) {
+  page_id = disk_manager_->AllocatePage();
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = GetBufferPoolManager(page_id)->NewPageWithId(page_id);
+  if (page == nullptr) {
+    // every frame of the owning instance is pinned, give the page id back
+    disk_manager_->DeAllocatePage(page_id);
+    page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+Page *ParallelBufferPoolManager::NewPageWithId(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->NewPageWithId(page_id);
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+page_id_t ParallelBufferPoolManager::ReadAhead(page_id_t page_id, size_t next_page_id_offset) {
+  return GetBufferPoolManager(page_id)->ReadAhead(page_id, next_page_id_offset);
+}
+
+frame_id_t ParallelBufferPoolManager::ReserveReadAhead(page_id_t page_id, Page **page, bool *busy) {
+  return GetBufferPoolManager(page_id)->ReserveReadAhead(page_id, page, busy);
+}
+
+void ParallelBufferPoolManager::GetResidentPages(std::vector<page_id_t> *page_ids) {
+  std::vector<std::vector<page_id_t>> instance_page_ids(num_instances_);
+  size_t max_size = 0;
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_[i]->GetResidentPages(&instance_page_ids[i]);
+    max_size = std::max(max_size, instance_page_ids[i].size());
+  }
+  for (size_t j = 0; j < max_size; j++) {
+    for (auto &ids : instance_page_ids) {
+      if (j < ids.size()) {
+        page_ids->push_back(ids[j]);
+      }
+    }
+  }
+}
+
+frame_id_t ParallelBufferPoolManager::ReserveFrame(page_id_t page_id, Page **page, bool *pool_full, bool *busy) {
+  bool instance_full = false;
+  frame_id_t frame_id = GetBufferPoolManager(page_id)->ReserveFrame(page_id, page, &instance_full, busy);
+  // keep filling the other instances until all of them are full
+  if (instance_full) {
+    *pool_full = true;
+    for (auto instance : instances_) {
+      std::unique_lock<std::recursive_mutex> lock(instance->latch_, std::defer_lock);
+      if (busy == nullptr) {
+        lock.lock();
+      } else if (!lock.try_lock()) {
+        // the instance may still have free frames
+        *pool_full = false;
+        continue;
+      }
+      *pool_full = *pool_full && instance->free_list_.empty();
+    }
+  }
+  return frame_id;
+}
+
+void ParallelBufferPoolManager::FinishReads(const std::vector<std::pair<page_id_t, frame_id_t>> &reads) {
+  std::vector<std::vector<std::pair<page_id_t, frame_id_t>>> instance_reads(num_instances_);
+  for (auto &read : reads) {
+    instance_reads[read.first % num_instances_].push_back(read);
+  }
+  for (size_t i = 0; i < num_instances_; i++) {
+    if (!instance_reads[i].empty()) {
+      instances_[i]->FinishReads(instance_reads[i]);
+    }
+  }
+}
+
+bool ParallelBufferPoolManager::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+bool ParallelBufferPoolManager::Resize(size_t new_pool_size) {
+  if (new_pool_size < num_instances_) {
+    return false;
+  }
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_[i]->Resize(new_pool_size / num_instances_ + (i < new_pool_size % num_instances_ ? 1 : 0));
+  }
+  return true;
+}
+
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
+
+void ParallelBufferPoolManager::EnableBackgroundCleaner(double clean_fraction, std::chrono::milliseconds interval) {
+  for (auto instance : instances_) {
+    instance->EnableBackgroundCleaner(clean_fraction, interval);
+  }
+}
+
+void ParallelBufferPoolManager::DisableBackgroundCleaner() {
+  for (auto instance : instances_) {
+    instance->DisableBackgroundCleaner();
+  }
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (auto instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
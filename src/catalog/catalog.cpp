@@ -1,5 +1,7 @@
 #include "catalog/catalog.h"
 
+#include "page/index_roots_page.h"
+
 void CatalogMeta::SerializeTo(char *buf) const {
     ASSERT(GetSerializedSize() <= PAGE_SIZE, "Failed to serialize catalog metadata to disk.");
     MACH_WRITE_UINT32(buf, CATALOG_METADATA_MAGIC_NUM);
@@ -123,7 +125,8 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     Schema* new_schema = nullptr;
     new_schema = Schema::DeepCopySchema(schema);
     TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, new_schema, nullptr, log_manager_, lock_manager_);  // 新建一个table_heap
-    TableMetadata *meta_data = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), new_schema);   // 新建一个table_meta_data
+    TableMetadata *meta_data = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(),
+                                                     table_heap->GetFreeSpaceMapPageId(), new_schema);   // 新建一个table_meta_data
     table_info->Init(meta_data, table_heap);    // 初始化table_info
     table_names_[table_name] = table_id;        //将catalog manager中的存放table_id和table_info的map初始化
     tables_[table_id] = table_info;
@@ -356,10 +359,21 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
     table_names_[meta_data->GetTableName()] = table_id;     //将table_name和table_id对应起来
 
     TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, meta_data->GetFirstPageId(), meta_data->GetSchema(),
-                                                log_manager_, lock_manager_);
+                                                log_manager_, lock_manager_, meta_data->GetFreeSpaceMapPageId());
     table_info->Init(meta_data, table_heap);
     tables_[table_id] = table_info;
-    buffer_pool_manager_->UnpinPage(page_id, false);
+    bool is_dirty = false;
+    if (meta_data->GetFreeSpaceMapPageId() == INVALID_PAGE_ID)     // 旧格式的元信息没有空闲空间表，建好后写回元信息页
+    {
+        page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+        if (fsm_page_id != INVALID_PAGE_ID)
+        {
+            meta_data->SetFreeSpaceMapPageId(fsm_page_id);
+            meta_data->SerializeTo(meta_data_page->GetData());
+            is_dirty = true;
+        }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, is_dirty);
     return DB_SUCCESS;
 }
  
@@ -413,4 +427,148 @@ dberr_t CatalogManager::GetTable(const table_id_t table_id, TableInfo *&table_in
         return DB_TABLE_NOT_EXIST;
     table_info = table_iter->second;
     return DB_SUCCESS;
-}
\ No newline at end of file
+}
+
+void CatalogManager::CollectPages(std::map<page_id_t, std::pair<PageOwner, uint32_t>> *pages)
+{
+    for (auto &[table_id, page_id] : catalog_meta_->table_meta_pages_)
+        pages->emplace(page_id, std::make_pair(PageOwner::TABLE_META, table_id));
+    for (auto &[index_id, page_id] : catalog_meta_->index_meta_pages_)
+        pages->emplace(page_id, std::make_pair(PageOwner::INDEX_META, index_id));
+    std::vector<page_id_t> page_ids;
+    for (auto &[table_id, table_info] : tables_)        // 沿着链表找到每个表的数据页
+    {
+        page_ids.clear();
+        table_info->GetTableHeap()->GetPageIds(&page_ids);
+        for (auto page_id : page_ids)
+            pages->emplace(page_id, std::make_pair(PageOwner::TABLE_HEAP, table_id));
+        page_ids.clear();
+        table_info->GetTableHeap()->GetFreeSpaceMapPageIds(&page_ids);
+        for (auto page_id : page_ids)
+            pages->emplace(page_id, std::make_pair(PageOwner::TABLE_FSM, table_id));
+    }
+    for (auto &[index_id, index_info] : indexes_)       // 遍历每个索引的B+树
+    {
+        page_ids.clear();
+        index_info->GetIndex()->GetPageIds(&page_ids);
+        for (auto page_id : page_ids)
+            pages->emplace(page_id, std::make_pair(PageOwner::INDEX, index_id));
+    }
+}
+
+void CatalogManager::StartCompaction(size_t *freed_pages)
+{
+    compaction_ = std::make_unique<CompactionState>();
+    CollectPages(&compaction_->pages_);
+
+    // 释放已分配但不属于任何表和索引的页，例如被删除的表和索引的页
+    page_id_t last_page_id = buffer_pool_manager_->GetLastAllocatedPageId();
+    for (page_id_t page_id = INDEX_ROOTS_PAGE_ID + 1; page_id <= last_page_id; page_id++)
+    {
+        if (compaction_->pages_.count(page_id) == 0 && !buffer_pool_manager_->IsPageFree(page_id) &&
+            buffer_pool_manager_->DeletePage(page_id))
+            ++*freed_pages;
+    }
+    // 被删除的索引的根页已经释放，删除它们在index_roots_page中的记录
+    auto roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    for (int i = roots_page->GetIndexCount() - 1; i >= 0; i--)
+    {
+        if (indexes_.count(roots_page->GetIndexIdAt(i)) == 0)
+            roots_page->Delete(roots_page->GetIndexIdAt(i));
+    }
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+dberr_t CatalogManager::CompactPages(size_t max_pages, size_t *moved_pages, size_t *freed_pages)
+{
+    *moved_pages = 0;
+    *freed_pages = 0;
+    // 上一步之后有其他语句分配或释放了页，记下的页的归属可能已经过时，重新收集
+    BufferPoolStats stats = buffer_pool_manager_->GetStats();
+    if (compaction_ == nullptr || compaction_->new_pages_ != stats.new_pages_ ||
+        compaction_->deleted_pages_ != stats.deleted_pages_)
+        StartCompaction(freed_pages);
+    auto &pages = compaction_->pages_;
+
+    // 从文件末尾开始，把页移到最前面的空闲页
+    std::unordered_map<table_id_t, std::unordered_map<page_id_t, page_id_t>> moved_rows;
+    while (!pages.empty() && *moved_pages < max_pages)
+    {
+        auto iter = std::prev(pages.end());
+        page_id_t old_page_id = iter->first;
+        page_id_t new_page_id;
+        if (buffer_pool_manager_->NewPage(new_page_id) == nullptr)
+            break;
+        buffer_pool_manager_->UnpinPage(new_page_id, false);
+        if (new_page_id > old_page_id)      // 前面已经没有空闲页了
+        {
+            buffer_pool_manager_->DeletePage(new_page_id);
+            break;
+        }
+        auto [owner, id] = iter->second;
+        switch (owner)
+        {
+            case PageOwner::TABLE_META:
+            case PageOwner::INDEX_META:
+            {
+                Page *old_page = buffer_pool_manager_->FetchPage(old_page_id);
+                Page *new_page = buffer_pool_manager_->FetchPage(new_page_id);
+                memcpy(new_page->GetData(), old_page->GetData(), PAGE_SIZE);
+                buffer_pool_manager_->UnpinPage(old_page_id, false);
+                buffer_pool_manager_->UnpinPage(new_page_id, true);
+                if (owner == PageOwner::TABLE_META)
+                    catalog_meta_->table_meta_pages_[id] = new_page_id;
+                else
+                    catalog_meta_->index_meta_pages_[id] = new_page_id;
+                break;
+            }
+            case PageOwner::TABLE_HEAP:
+            {
+                TableInfo *table_info = tables_[id];
+                table_info->GetTableHeap()->RelocatePage(old_page_id, new_page_id);
+                table_info->GetTableMeta()->SetFirstPageId(table_info->GetTableHeap()->GetFirstPageId());
+                moved_rows[id][old_page_id] = new_page_id;
+                break;
+            }
+            case PageOwner::TABLE_FSM:
+            {
+                TableInfo *table_info = tables_[id];
+                table_info->GetTableHeap()->RelocateFreeSpaceMapPage(old_page_id, new_page_id);
+                table_info->GetTableMeta()->SetFreeSpaceMapPageId(table_info->GetTableHeap()->GetFreeSpaceMapPageId());
+                moved_rows[id];     // 没有行移动，但表的元信息需要重写
+                break;
+            }
+            case PageOwner::INDEX:
+                indexes_[id]->GetIndex()->RelocatePage(old_page_id, new_page_id);
+                break;
+        }
+        buffer_pool_manager_->DeletePage(old_page_id);
+        pages.erase(iter);      // 移到的空闲页比剩下的页都低，不会再移动
+        ++*moved_pages;
+    }
+
+    for (auto &[table_id, moved] : moved_rows)
+    {
+        // 表的第一页可能移动了，重写表的元信息页
+        Page *meta_data_page = buffer_pool_manager_->FetchPage(catalog_meta_->table_meta_pages_[table_id]);
+        tables_[table_id]->GetTableMeta()->SerializeTo(meta_data_page->GetData());
+        buffer_pool_manager_->UnpinPage(meta_data_page->GetPageId(), true);
+        // 索引中的RowId指向新的数据页
+        for (auto &[index_id, index_info] : indexes_)
+        {
+            if (index_info->GetTableInfo()->GetTableId() == table_id)
+                index_info->GetIndex()->RelocateRows(moved);
+        }
+    }
+    if (*moved_pages < max_pages)       // 压缩完成
+    {
+        compaction_.reset();
+    }
+    else
+    {
+        stats = buffer_pool_manager_->GetStats();
+        compaction_->new_pages_ = stats.new_pages_;
+        compaction_->deleted_pages_ = stats.deleted_pages_;
+    }
+    return FlushCatalogMetaPage();
+}
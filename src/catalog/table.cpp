@@ -18,6 +18,9 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
     // table heap root page id
     MACH_WRITE_TO(page_id_t, buf, root_page_id_);
     buf += 4;
+    // free space map page id
+    MACH_WRITE_TO(page_id_t, buf, fsm_page_id_);
+    buf += 4;
     // table schema
     buf += schema_->SerializeTo(buf);
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
@@ -36,6 +39,7 @@ uint32_t TableMetadata::GetSerializedSize() const
     size += 4; // table name length
     size += table_name_.length(); // table name
     size += 4; // root page id
+    size += 4; // free space map page id
     size += schema_->GetSerializedSize(); // table schema
     return size;
 }
@@ -48,7 +52,8 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     // magic num
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM, "Failed to deserialize table info.");
+    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM || magic_num == TABLE_METADATA_MAGIC_NUM_V1,
+           "Failed to deserialize table info.");
     // table id
     table_id_t table_id = MACH_READ_FROM(table_id_t, buf);
     buf += 4;
@@ -60,11 +65,17 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     // table heap root page id
     page_id_t root_page_id = MACH_READ_FROM(page_id_t, buf);
     buf += 4;
+    // free space map page id, a table written without one builds its map on first use
+    page_id_t fsm_page_id = INVALID_PAGE_ID;
+    if (magic_num == TABLE_METADATA_MAGIC_NUM) {
+        fsm_page_id = MACH_READ_FROM(page_id_t, buf);
+        buf += 4;
+    }
     // table schema
     TableSchema *schema = nullptr;
     buf += TableSchema::DeserializeFrom(buf, schema);
     // allocate space for table metadata
-    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+    table_meta = new TableMetadata(table_id, table_name, root_page_id, fsm_page_id, schema);
     return buf - p;
 }
 
@@ -74,10 +85,15 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                                     TableSchema *schema) {
+                                     page_id_t fsm_page_id, TableSchema *schema) {
   // allocate space for table metadata
-  return new TableMetadata(table_id, table_name, root_page_id, schema);
+  return new TableMetadata(table_id, table_name, root_page_id, fsm_page_id, schema);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                             page_id_t fsm_page_id, TableSchema *schema)
+    : table_id_(table_id),
+      table_name_(table_name),
+      root_page_id_(root_page_id),
+      fsm_page_id_(fsm_page_id),
+      schema_(schema) {}
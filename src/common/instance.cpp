@@ -3,16 +3,28 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+#include "buffer/parallel_buffer_pool_manager.h"
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances)
     : db_file_name_(std::move(db_name)), init_(init) {
   // Init database file if needed
   db_file_name_ = "./databases/"+db_file_name_;
   if (init_) {
-    remove(db_file_name_.c_str());
+    DiskManager::RemoveDatabaseFiles(db_file_name_);
+    remove(GetWarmUpFileName().c_str());
   }
   // Initialize components
   disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  if (buffer_pool_instances > 1) {
+    bpm_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size / buffer_pool_instances, disk_mgr_);
+  } else {
+    bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  }
+  bpm_->EnableBackgroundCleaner();
+  if (!init_) {
+    bpm_->WarmUp(GetWarmUpFileName());
+  }
 
   // Allocate static page for db storage engine
   if (init) {
@@ -43,10 +55,17 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
 
 DBStorageEngine::~DBStorageEngine() {
   delete catalog_mgr_;
+  bpm_->DumpResidentPages(GetWarmUpFileName());
   delete bpm_;
   delete disk_mgr_;
 }
 
+std::string DBStorageEngine::GetWarmUpFileName() const {
+  // a hidden file next to the database file, so that it is never taken for a database itself
+  auto pos = db_file_name_.find_last_of('/') + 1;
+  return db_file_name_.substr(0, pos) + "." + db_file_name_.substr(pos) + ".warm";
+}
+
 std::unique_ptr<ExecuteContext> DBStorageEngine::MakeExecuteContext(Transaction *txn) {
   return std::make_unique<ExecuteContext>(txn, catalog_mgr_, bpm_);
 }
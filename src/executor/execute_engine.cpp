@@ -4,6 +4,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 
 #include "common/result_writer.h"
@@ -148,6 +149,14 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeShowBufferStatus:
+      return ExecuteShowBufferStatus(ast, context.get());
+    case kNodeSetVariable:
+      return ExecuteSetVariable(ast, context.get());
+    case kNodeCheckpoint:
+      return ExecuteCheckpoint(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
     default:
       break;
   }
@@ -603,15 +612,18 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     }
     IndexInfo* new_indexinfo;
     dberr_t if_createindex_success = current_CMgr->CreateIndex(table_name, index_name, vec_index_colum_lists, nullptr, new_indexinfo, "");
-    TableIterator table_iter = target_table->GetTableHeap()->Begin(nullptr);
-    Row keys{};
+    BufferAccessStrategy strategy;
+    TableIterator table_iter = target_table->GetTableHeap()->Begin(nullptr, &strategy);
+    std::vector<std::pair<Row, RowId>> entries;   // 先收集已有记录的索引键，再一次性建立索引
     while(table_iter != target_table->GetTableHeap()->End())
     {
         Row new_row = *table_iter;
+        Row keys{};
         new_row.GetKeyFromRow(target_table->GetSchema(), new_indexinfo->GetIndexKeySchema(), keys);
-        new_indexinfo->GetIndex()->InsertEntry(keys, new_row.GetRowId(), nullptr);
+        entries.emplace_back(keys, new_row.GetRowId());
         table_iter++;
     }
+    new_indexinfo->GetIndex()->BulkLoad(entries, nullptr);
     if(if_createindex_success != DB_SUCCESS)
             return if_createindex_success;
     return DB_SUCCESS;
@@ -649,7 +661,8 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   out:;
     TableInfo* target_table = nullptr;
     current_CMgr->GetTable(table_name, target_table);
-    TableIterator table_iter = target_table->GetTableHeap()->Begin(nullptr);
+    BufferAccessStrategy strategy;
+    TableIterator table_iter = target_table->GetTableHeap()->Begin(nullptr, &strategy);
     Row keys{};
     IndexInfo* tmp_indexinfo;
     dberr_t if_getindex_success = current_CMgr->GetIndex(table_name, index_name, tmp_indexinfo);
@@ -715,31 +728,23 @@ dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context)
         std::cout << "fail to open '" << filename << "'" << endl;
         return DB_FAILED;
     }
-    int buffer_size = 1024;
-    char* cmd = new char[buffer_size];
+    std::string cmd;                          // 语句没有长度限制，导入数据的多行insert可以很长
 
     while (true)
     {
         char tmp_char;
-        int tmp_counter = 0;
+        cmd.clear();
         do
         {
             if(exefstream.eof())    // 文件结束
             {
-                  delete []cmd;
                   return DB_SUCCESS;
             }
             exefstream.get(tmp_char);   // 读取一个字符
-            cmd[tmp_counter++] = tmp_char;    // 存入buffer
-            if(tmp_counter >= buffer_size)    // buffer溢出
-            {
-                  std::cout << "buffer overflow" << endl;
-                  return DB_FAILED;
-            }
+            cmd.push_back(tmp_char);    // 存入buffer
         }while(tmp_char != ';');
-        cmd[tmp_counter] = 0;   // 末尾加上'\0'
 
-        YY_BUFFER_STATE bp = yy_scan_string(cmd);
+        YY_BUFFER_STATE bp = yy_scan_string(cmd.c_str());
         if (bp == nullptr)
         {
             LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
@@ -786,3 +791,155 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context)
     return DB_SUCCESS;
 }
 
+dberr_t ExecuteEngine::ExecuteShowBufferStatus(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowBufferStatus" << std::endl;
+#endif
+  ASSERT(ast->type_ == kNodeShowBufferStatus, "Unexpected node type.");
+  std::vector<std::string> header{"Database",   "Pool Size", "Hits",          "Misses",    "Hit Ratio",  "Evictions",
+                                  "FG Writes",  "BG Writes", "New Pages",     "Pin Waits", "Disk Reads", "Read Time(ms)"};
+  std::vector<std::vector<std::string>> rows;
+  for (auto &kv : dbs_) {
+    if (kv.second == nullptr) {
+      continue;
+    }
+    BufferPoolStats stats = kv.second->bpm_->GetStats();
+    std::stringstream hit_ratio, read_time;
+    hit_ratio << std::fixed << std::setprecision(4) << stats.HitRatio();
+    read_time << std::fixed << std::setprecision(3) << stats.disk_read_time_us_ / 1000.0;
+    rows.push_back({kv.first, std::to_string(stats.pool_size_), std::to_string(stats.hits_),
+                    std::to_string(stats.misses_), hit_ratio.str(), std::to_string(stats.evictions_),
+                    std::to_string(stats.foreground_writebacks_), std::to_string(stats.background_writebacks_),
+                    std::to_string(stats.new_pages_), std::to_string(stats.pin_waits_),
+                    std::to_string(stats.disk_reads_), read_time.str()});
+  }
+  vector<int> data_width;
+  for (const auto &cell : header) {
+    data_width.push_back(int(cell.length()));
+  }
+  for (const auto &row : rows) {
+    for (size_t i = 0; i < row.size(); i++) {
+      data_width[i] = max(data_width[i], int(row[i].length()));
+    }
+  }
+  std::stringstream ss;
+  ResultWriter writer(ss);
+  writer.Divider(data_width);
+  writer.BeginRow();
+  for (size_t i = 0; i < header.size(); i++) {
+    writer.WriteHeaderCell(header[i], data_width[i]);
+  }
+  writer.EndRow();
+  writer.Divider(data_width);
+  for (const auto &row : rows) {
+    writer.BeginRow();
+    for (size_t i = 0; i < row.size(); i++) {
+      writer.WriteCell(row[i], data_width[i]);
+    }
+    writer.EndRow();
+  }
+  writer.Divider(data_width);
+  std::cout << writer.stream_.rdbuf();
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSetVariable" << std::endl;
+#endif
+  ASSERT(ast->type_ == kNodeSetVariable, "Unexpected node type.");
+  std::string name(ast->child_->val_);
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  std::string value(ast->child_->next_->val_);
+  std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+  if (name != "buffer_pool_size" && name != "durability") {
+    std::cout << "Unknown variable: " << name << std::endl;
+    return DB_FAILED;
+  }
+  // both variables are set per database
+  DBStorageEngine *current_db_engine = dbs_[current_db_];
+  if (current_db_engine == nullptr) {
+    ExecuteInformation(DB_NOT_EXIST);
+    return DB_NOT_EXIST;
+  }
+  if (name == "buffer_pool_size") {
+    char *end = nullptr;
+    long long pool_size = std::strtoll(value.c_str(), &end, 10);
+    if (*end != '\0' || pool_size <= 0 || !current_db_engine->bpm_->Resize(static_cast<size_t>(pool_size))) {
+      std::cout << "Invalid buffer pool size: " << value << std::endl;
+      return DB_FAILED;
+    }
+  } else {
+    static const std::unordered_map<std::string, DurabilityMode> durability_modes{
+        {"sync_every_write", DurabilityMode::SYNC_EVERY_WRITE},
+        {"group_commit", DurabilityMode::GROUP_COMMIT},
+        {"os_buffered", DurabilityMode::OS_BUFFERED}};
+    auto iter = durability_modes.find(value);
+    if (iter == durability_modes.end()) {
+      std::cout << "Invalid durability mode: " << value << std::endl;
+      return DB_FAILED;
+    }
+    current_db_engine->disk_mgr_->SetDurabilityMode(iter->second);
+  }
+  std::cout << "Set " << name << " of " << current_db_ << " to " << value << "." << std::endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteCheckpoint(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteCheckpoint" << std::endl;
+#endif
+  ASSERT(ast->type_ == kNodeCheckpoint, "Unexpected node type.");
+  // every open database, like the checkpoint on shutdown
+  for (auto &kv : dbs_) {
+    if (kv.second == nullptr) {
+      continue;
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    size_t pages = kv.second->bpm_->FlushAllPages();
+    double duration_time =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    std::stringstream ss;
+    ss << "Checkpoint of " << kv.first << ": " << pages << " pages written (" << std::fixed << std::setprecision(2)
+       << duration_time << " ms).";
+    std::cout << ss.str() << std::endl;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  ASSERT(ast->type_ == kNodeVacuum, "Unexpected node type.");
+  DBStorageEngine *current_db_engine = dbs_[current_db_];
+  if (current_db_engine == nullptr) {
+    ExecuteInformation(DB_NOT_EXIST);
+    return DB_NOT_EXIST;
+  }
+  auto start_time = std::chrono::steady_clock::now();
+  size_t moved_pages = 0;
+  size_t freed_pages = 0;
+  size_t step_moved_pages;
+  do {
+    size_t step_freed_pages;
+    dberr_t result = current_db_engine->catalog_mgr_->CompactPages(DEFAULT_COMPACTION_STEP_PAGES, &step_moved_pages,
+                                                                  &step_freed_pages);
+    if (result != DB_SUCCESS) {
+      return result;
+    }
+    moved_pages += step_moved_pages;
+    freed_pages += step_freed_pages;
+  } while (step_moved_pages == DEFAULT_COMPACTION_STEP_PAGES);
+  // the moved pages are written back before the file is cut off after the last of them
+  current_db_engine->bpm_->FlushAllPages();
+  size_t released_bytes = current_db_engine->disk_mgr_->TruncateFile();
+  double duration_time =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  std::stringstream ss;
+  ss << "Vacuum of " << current_db_ << ": " << moved_pages << " pages moved, " << freed_pages << " pages freed, file "
+     << "shrunk by " << released_bytes / PAGE_SIZE << " pages (" << std::fixed << std::setprecision(2)
+     << duration_time << " ms).";
+  std::cout << ss.str() << std::endl;
+  return DB_SUCCESS;
+}
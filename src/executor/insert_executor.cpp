@@ -4,6 +4,9 @@
 
 #include "executor/executors/insert_executor.h"
 
+#include <string>
+#include <unordered_set>
+
 InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor))
@@ -21,10 +24,20 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   if (is_end) {
     return false;
   }
-  Row to_insert_tuple{};
+  Row child_row{};
   RowId emit_rid;
+  std::vector<Row> rows;
+  while (child_executor_->Next(&child_row, &emit_rid)) //child executor 为 value executor
+  {
+    rows.push_back(child_row);
+  }
+  if (rows.size() >= static_cast<size_t>(DEFAULT_BULK_INSERT_MIN_ROWS))
+  {
+    BulkInsert(rows);
+    rows.clear();
+  }
 
-  while (child_executor_->Next(&to_insert_tuple, &emit_rid)) //child executor 为 value executor
+  for (auto &to_insert_tuple : rows)
   {
     Row keys{};
     vector<RowId> result;
@@ -53,4 +66,59 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   *row = Row{};
   is_end = true;
   return true;
-}
\ No newline at end of file
+}
+
+void InsertExecutor::BulkInsert(std::vector<Row> &rows) {
+  // 与逐行插入一致：在第一个重复的键处停止，跳过放不进一页的行（它们不进入索引，不参与之后的重复判断）；
+  // 批内的重复通过序列化后的键查找
+  std::vector<std::unordered_set<std::string>> batch_keys(table_indexes_.size());
+  size_t count = 0;
+  Row keys{};
+  for (size_t i = 0; i < rows.size(); i++) {
+    std::vector<std::string> row_keys;
+    for (size_t j = 0; j < table_indexes_.size(); j++) {
+      auto index_info = table_indexes_[j];
+      rows[i].GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), keys);
+      std::vector<RowId> result;
+      index_info->GetIndex()->ScanKey(keys, result, exec_ctx_->GetTransaction());
+      std::string key(keys.GetSerializedSize(index_info->GetIndexKeySchema()), '\0');
+      keys.SerializeTo(key.data(), index_info->GetIndexKeySchema());
+      if (!result.empty() || batch_keys[j].count(key) != 0) {
+        break;
+      }
+      row_keys.push_back(std::move(key));
+    }
+    if (row_keys.size() < table_indexes_.size()) {
+      LOG(WARNING) << "Insert failed, duplicate key";
+      break;
+    }
+    if (rows[i].GetSerializedSize(table_info_->GetSchema()) > TablePage::SIZE_MAX_ROW) {
+      LOG(WARNING) << "Insert failed, row too large";
+      continue;
+    }
+    for (size_t j = 0; j < table_indexes_.size(); j++) {
+      batch_keys[j].insert(std::move(row_keys[j]));
+    }
+    if (count != i) {
+      rows[count] = std::move(rows[i]);
+    }
+    count++;
+  }
+  rows.resize(count);
+  if (!table_info_->GetTableHeap()->BulkInsert(rows, exec_ctx_->GetTransaction())) {
+    LOG(WARNING) << "Insert failed, cannot allocate pages";
+    return;
+  }
+  // 索引的维护推迟到所有行插入之后，每个索引一批
+  for (auto index_info : table_indexes_) {
+    std::vector<std::pair<Row, RowId>> entries;
+    entries.reserve(rows.size());
+    for (auto &to_insert_tuple : rows) {
+      to_insert_tuple.GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), keys);
+      entries.emplace_back(keys, to_insert_tuple.GetRowId());
+    }
+    if (index_info->GetIndex()->BulkLoad(entries, exec_ctx_->GetTransaction()) != DB_SUCCESS) {
+      LOG(WARNING) << "Insert failed, cannot update index " << index_info->GetIndexName();
+    }
+  }
+}
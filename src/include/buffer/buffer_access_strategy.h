@@ -0,0 +1,49 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "page/page.h"
+
+/**
+ * BufferAccessStrategy is a small private ring of frames used by bulk reads such as sequential scans.
+ *
+ * When a page fetched through the strategy is not resident, the buffer pool reuses the frame of the current ring slot
+ * instead of evicting a page from the shared replacer, so a scan over a table much larger than the buffer pool only
+ * ever occupies ring_size frames and leaves the rest of the working set alone. Pages that are already resident are
+ * served from their frames as usual.
+ *
+ * A strategy belongs to a single scan and is not thread safe.
+ */
+class BufferAccessStrategy {
+ public:
+  explicit BufferAccessStrategy(size_t ring_size = DEFAULT_SCAN_RING_SIZE)
+      : ring_(ring_size, {nullptr, INVALID_PAGE_ID}) {}
+
+  /**
+   * @param[out] page_id the page the ring loaded into the frame of the current slot
+   * @return the frame of the current slot, nullptr if the slot is still empty
+   */
+  Page *GetCurrentBuffer(page_id_t *page_id) const {
+    *page_id = ring_[current_].second;
+    return ring_[current_].first;
+  }
+
+  /**
+   * Record the frame a page was just loaded into in the current slot and move on to the next one.
+   */
+  void AddBuffer(Page *page, page_id_t page_id) {
+    ring_[current_] = {page, page_id};
+    current_ = (current_ + 1) % ring_.size();
+  }
+
+  inline size_t GetRingSize() const { return ring_.size(); }
+
+ private:
+  std::vector<std::pair<Page *, page_id_t>> ring_;
+  size_t current_{0};
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
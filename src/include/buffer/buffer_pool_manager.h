@@ -1,10 +1,22 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <list>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/frame_arena.h"
 #include "buffer/lru_replacer.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
@@ -12,25 +24,227 @@
 
 using namespace std;
 
+/**
+ * Snapshot of the counters of a buffer pool, see BufferPoolManager::GetStats.
+ */
+struct BufferPoolStats {
+  size_t pool_size_{0};                  // number of frames
+  uint64_t hits_{0};                     // fetches served from a resident frame
+  uint64_t misses_{0};                   // fetches that had to read the page from disk
+  uint64_t evictions_{0};                // resident pages dropped to reuse their frame
+  uint64_t foreground_writebacks_{0};    // dirty pages written back on the eviction path
+  uint64_t background_writebacks_{0};    // dirty pages written back by the background cleaner
+  uint64_t new_pages_{0};                // pages allocated through NewPage
+  uint64_t deleted_pages_{0};            // pages freed through DeletePage
+  uint64_t pin_waits_{0};                // requests that found every frame pinned or waited for in-flight page I/O
+  uint64_t disk_reads_{0};               // pages read from disk, including read-ahead
+  uint64_t disk_read_time_us_{0};        // time spent in those reads
+
+  BufferPoolStats &operator+=(const BufferPoolStats &other) {
+    pool_size_ += other.pool_size_;
+    hits_ += other.hits_;
+    misses_ += other.misses_;
+    evictions_ += other.evictions_;
+    foreground_writebacks_ += other.foreground_writebacks_;
+    background_writebacks_ += other.background_writebacks_;
+    new_pages_ += other.new_pages_;
+    deleted_pages_ += other.deleted_pages_;
+    pin_waits_ += other.pin_waits_;
+    disk_reads_ += other.disk_reads_;
+    disk_read_time_us_ += other.disk_read_time_us_;
+    return *this;
+  }
+
+  /** @return fraction of fetches served without a disk read */
+  double HitRatio() const { return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / (hits_ + misses_); }
+};
+
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /**
+   * @param replacer_type replacement policy used to pick victim frames
+   * @param huge_pages back the frames with transparent huge pages, see FrameArena
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             ReplacerType replacer_type = ReplacerType::LRU, bool huge_pages = false);
+
+  virtual ~BufferPoolManager();
+
+  virtual Page *FetchPage(page_id_t page_id);
+
+  /**
+   * Fetch a page for a bulk read. A page that is not resident is loaded into the frame of the strategy's current ring
+   * slot when that frame can be recycled, instead of evicting a page chosen by the shared replacer.
+   * @param strategy ring of the bulk read, nullptr to fetch the page as usual
+   */
+  virtual Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy);
+
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty);
+
+  virtual bool FlushPage(page_id_t page_id);
+
+  /**
+   * Write back every dirty page with one DiskManager::WritePages call, so adjacent pages go out together in file
+   * order, then sync the database file once. Used for checkpoints and on shutdown.
+   * @return number of pages written
+   */
+  virtual size_t FlushAllPages();
+
+  virtual Page *NewPage(page_id_t &page_id);
+
+  /**
+   * Allocate count pages that are contiguous in the database file. The pages are brought in one at a time, zeroed,
+   * passed to init and unpinned dirty, so the run needs a single free frame rather than count of them.
+   * @param init sets up the content of each page, in page id order
+   * @return the id of the first page, INVALID_PAGE_ID if no run of count pages or no frame was available
+   */
+  page_id_t NewPages(size_t count, const std::function<void(Page *)> &init);
+
+  virtual bool DeletePage(page_id_t page_id);
+
+  virtual bool IsPageFree(page_id_t page_id);
+
+  /** @return the highest allocated page id, INVALID_PAGE_ID if no page is allocated */
+  page_id_t GetLastAllocatedPageId() { return disk_manager_->GetLastAllocatedPageId(); }
 
-  ~BufferPoolManager();
+  virtual bool CheckAllUnpinned();
 
-  Page *FetchPage(page_id_t page_id);
+  /** @return the total number of frames managed by this buffer pool */
+  virtual size_t GetPoolSize() { return pool_size_; }
 
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  /**
+   * Change the number of frames while the pool is in use. Growing takes effect immediately. Shrinking evicts the
+   * unpinned pages held by the frames beyond new_pool_size right away, writing them back if dirty; a frame that is
+   * still pinned is released once its last pin is dropped, so GetPoolSize() reaches new_pool_size only then.
+   * @return false if new_pool_size is 0
+   */
+  virtual bool Resize(size_t new_pool_size);
+
+  /**
+   * Start a background thread that keeps the next clean_fraction * pool_size victim candidates clean, writing dirty
+   * pages back in page id order before the eviction path has to.
+   */
+  virtual void EnableBackgroundCleaner(double clean_fraction = DEFAULT_CLEAN_FRACTION,
+                                       std::chrono::milliseconds interval = std::chrono::milliseconds(
+                                           DEFAULT_CLEANER_INTERVAL_MS));
+
+  /** Stop the background cleaner thread, if running. */
+  virtual void DisableBackgroundCleaner();
+
+  /**
+   * Ask the I/O worker to read a page into the pool in the background. Nothing happens if it is already resident.
+   */
+  void PrefetchPage(page_id_t page_id);
+
+  /** Prefetch count pages with consecutive ids, starting at first_page_id. */
+  void PrefetchRange(page_id_t first_page_id, size_t count);
+
+  /**
+   * Prefetch up to count pages of a linked chain, e.g. the pages of a table heap or the leaves of a B+ tree. The I/O
+   * worker reads each page and follows the page id stored at next_page_id_offset inside it.
+   */
+  void PrefetchChain(page_id_t page_id, size_t count, size_t next_page_id_offset);
+
+  /** Set the number of upcoming pages iterators keep in flight, 0 disables read-ahead. */
+  inline void SetReadAheadWindow(size_t window) { read_ahead_window_ = window; }
+
+  inline size_t GetReadAheadWindow() const { return read_ahead_window_; }
+
+  /**
+   * Write the ids of the resident pages to file_name, one per line, most recently used first, so that WarmUp can bring
+   * them back after a restart. Safe to call while the pool is in use.
+   * @return false if the file could not be written
+   */
+  bool DumpResidentPages(const std::string &file_name);
 
-  bool FlushPage(page_id_t page_id);
+  /**
+   * Start a background thread that loads the pages listed by DumpResidentPages into free frames while queries are
+   * served. The most recent pages that fit into the pool are read in page id order, each run of consecutive ids with a
+   * single request of up to DEFAULT_WARM_UP_READ_PAGES pages. Warm-up never evicts a page and stops once the pool is
+   * full.
+   */
+  void WarmUp(const std::string &file_name);
 
-  Page *NewPage(page_id_t &page_id);
+  /** Block until the warm-up thread has loaded its pages. */
+  void WaitForWarmUp();
 
-  bool DeletePage(page_id_t page_id);
+  /** @return number of dirty pages written back synchronously when their frame was reused */
+  uint64_t GetForegroundWritebacks() { return GetStats().foreground_writebacks_; }
 
-  bool IsPageFree(page_id_t page_id);
+  /** @return number of dirty pages written back by the background cleaner */
+  uint64_t GetBackgroundWritebacks() { return GetStats().background_writebacks_; }
 
-  bool CheckAllUnpinned();
+  /**
+   * The counters are updated without taking the latch, so a snapshot taken under load is not atomic as a whole.
+   * @return snapshot of the counters of this buffer pool
+   */
+  virtual BufferPoolStats GetStats();
+
+ protected:
+  /**
+   * Used by buffer pools that do not own any frames themselves, e.g. ParallelBufferPoolManager.
+   */
+  explicit BufferPoolManager(DiskManager *disk_manager)
+      : pool_size_(0), target_pool_size_(0), disk_manager_(disk_manager), replacer_(nullptr) {}
+
+  /**
+   * Bring a page into the pool without pinning it. Called by the I/O worker.
+   * @param next_page_id_offset offset of the next page id inside the page, 0 if the page is not part of a chain
+   * @return the next page id of the chain, INVALID_PAGE_ID if there is none or the page could not be loaded
+   */
+  virtual page_id_t ReadAhead(page_id_t page_id, size_t next_page_id_offset);
+
+  /**
+   * Take a frame for a page the I/O worker is about to read, evicting a victim if needed. Fetching the page waits until
+   * FinishReads is called for it. A page that is not allocated on disk is skipped: a stale next page id of a chain may
+   * point at a freed page, whose id NewPage may hand out again.
+   * @param[out] busy see ReserveFrame
+   * @return the frame id, INVALID_FRAME_ID if the page is resident already, free, every frame is pinned or the latch
+   * is busy
+   */
+  virtual frame_id_t ReserveReadAhead(page_id_t page_id, Page **page, bool *busy = nullptr);
+
+  /** Stop the I/O worker and drop the pending prefetch requests. */
+  void StopPrefetcher();
+
+  /** Stop the warm-up thread, leaving the pages it has not loaded yet on disk. */
+  void StopWarmUp();
+
+  /**
+   * Append the dirty pages of this pool and mark them clean, the caller holds latch_ until they are written.
+   */
+  void CollectDirtyPages(std::vector<std::pair<page_id_t, const char *>> *pages);
+
+  /** Append the ids of the resident pages, most recently used first. */
+  virtual void GetResidentPages(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Take a free frame for a page that is about to be read from disk by the caller. The frame is not pinned, and
+   * fetching the page waits until FinishReads is called for it.
+   * @param[out] page the frame to read the page into
+   * @param[out] pool_full set to true if there was no free frame
+   * @param[out] busy if not null, do not wait for the latch, and set it to true if the latch is held by someone else. A
+   * caller that holds reserved frames must not wait, since a fetch of one of them holds the latch until it is read
+   * @return the frame id, INVALID_FRAME_ID if the page is resident already, there is no free frame or the latch is busy
+   */
+  virtual frame_id_t ReserveFrame(page_id_t page_id, Page **page, bool *pool_full, bool *busy = nullptr);
+
+  /** Make a page read into a frame returned by ReserveFrame or ReadAhead available. */
+  void FinishRead(page_id_t page_id, frame_id_t frame_id) { FinishReads({{page_id, frame_id}}); }
+
+  /**
+   * Make the pages read into frames returned by ReserveFrame available at once. Publishing them one by one could wait
+   * for the latch held by a fetch of one of the pages that are not published yet.
+   */
+  virtual void FinishReads(const std::vector<std::pair<page_id_t, frame_id_t>> &reads);
+
+  /**
+   * Bring a frame for an already allocated page id into the pool, pinned and zeroed.
+   * Used by NewPages, and by ParallelBufferPoolManager, which allocates page ids itself.
+   */
+  virtual Page *NewPageWithId(page_id_t page_id);
 
  private:
   /**
@@ -43,16 +257,106 @@ class BufferPoolManager {
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * Take a frame from the free list, or evict a victim from the replacer (writing it back if dirty).
+   * @return the frame id, INVALID_FRAME_ID if every frame is pinned
+   */
   frame_id_t TryToFindFreePage();
 
+  /**
+   * Drop a resident copy of a page whose id is about to be handed out again by NewPage, so that no two frames are
+   * mapped to one page id. The copy must not be pinned.
+   */
+  void DropStaleFrame(page_id_t page_id);
+
+  /**
+   * Write back the page held by a frame if it is dirty and detach it from the page table.
+   */
+  void EvictFrame(frame_id_t frame_id);
+
+  /** Hand an unpinned frame holding a page to the replacer, or evict it if the frame is being removed by Resize. */
+  void MakeEvictable(frame_id_t frame_id);
+
+  /** Put an empty frame back on the free list, or release it if the frame is being removed by Resize. */
+  void ReturnFrame(frame_id_t frame_id);
+
+  /** Release the empty frames at the back of pages_ that lie beyond the target pool size. */
+  void TrimFrames();
+
+  /**
+   * Block until the background cleaner has finished writing page_id. Must be called before any disk access to a page,
+   * so that a write of an older copy by the cleaner never lands after a newer read or write.
+   */
+  void WaitForCleaner(page_id_t page_id);
+
+  /**
+   * One round of the background cleaner: copy the dirty pages among the next victim candidates under the latch and
+   * write them back outside of it with a single DiskManager::WritePages call.
+   */
+  void CleanVictims();
+
+  /** Block until the I/O worker has finished reading into frame_id. */
+  void WaitForRead(frame_id_t frame_id);
+
+  void PrefetchWorker();
+
+  void EnqueuePrefetch(page_id_t page_id, size_t count, size_t next_page_id_offset);
+
+  /** Read count pages with consecutive ids into the pool, all of them in flight at once. Called by the I/O worker. */
+  void ReadAheadRange(page_id_t first_page_id, size_t count);
+
+  void WarmUpWorker(std::vector<page_id_t> page_ids);
+
+  /** Read a page from disk, accounting for the time spent. */
+  void ReadPageFromDisk(page_id_t page_id, char *page_data);
+
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
+  std::atomic<size_t> pool_size_;                    // number of pages in buffer pool
+  size_t target_pool_size_;                          // frames at or beyond this index are released once unpinned
+  std::deque<Page> pages_;                           // frames, grown and trimmed at the back so pages never move
+  FrameArena frames_;                                // page data of the frames, aligned for O_DIRECT
   DiskManager *disk_manager_;                        // pointer to the disk manager.
   unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
   Replacer *replacer_;                               // to find an unpinned page for replacement
   list<frame_id_t> free_list_;                       // to find a free page for replacement
   recursive_mutex latch_;                            // to protect shared data structure
+
+  std::thread cleaner_;                        // background cleaner thread
+  bool cleaner_running_{false};                // protected by cleaner_latch_
+  std::mutex cleaner_latch_;                   // protects cleaner_running_
+  std::condition_variable cleaner_cv_;         // wakes the cleaner up when it is disabled
+  double clean_fraction_{DEFAULT_CLEAN_FRACTION};
+  FrameArena cleaner_buffer_;                  // copies of the pages being written by the cleaner
+  std::unordered_set<page_id_t> cleaning_;     // pages the cleaner is writing, protected by cleaning_latch_
+  std::mutex cleaning_latch_;
+  std::condition_variable cleaning_cv_;        // signaled when the cleaner finishes a round of writes
+  struct PrefetchRequest {
+    page_id_t page_id_;
+    size_t count_;
+    size_t next_page_id_offset_;
+  };
+  std::thread prefetcher_;                       // I/O worker serving prefetch requests, started on first use
+  bool prefetcher_running_{false};               // protected by prefetch_latch_
+  std::deque<PrefetchRequest> prefetch_queue_;   // protected by prefetch_latch_
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  size_t read_ahead_window_{DEFAULT_READ_AHEAD_WINDOW};
+  std::vector<bool> prefetched_;                 // frames filled by read-ahead and not fetched since
+  std::unordered_set<frame_id_t> reading_;       // frames the I/O worker is reading into, protected by reading_latch_
+  std::mutex reading_latch_;
+  std::condition_variable reading_cv_;           // signaled when the I/O worker finishes a read
+  std::thread warmer_;                           // loads the pages listed by DumpResidentPages
+  std::atomic<bool> warm_up_running_{false};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> foreground_writebacks_{0};
+  std::atomic<uint64_t> background_writebacks_{0};
+  std::atomic<uint64_t> new_pages_{0};
+  std::atomic<uint64_t> deleted_pages_{0};
+  std::atomic<uint64_t> pin_waits_{0};
+  std::atomic<uint64_t> disk_reads_{0};
+  std::atomic<uint64_t> disk_read_time_us_{0};
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
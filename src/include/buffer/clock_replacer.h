@@ -36,6 +36,10 @@ class CLOCKReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) override;
+
+  void SetCapacity(size_t num_pages) override;
+
   size_t Size() override;
 
   enum class State { EMPTY, ACCESSED, UNUSED };
@@ -0,0 +1,61 @@
+#ifndef MINISQL_FRAME_ARENA_H
+#define MINISQL_FRAME_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * FrameArena holds the page data of the frames of a buffer pool, apart from their Page objects. Every frame is
+ * PAGE_SIZE bytes aligned to PAGE_SIZE, as O_DIRECT transfers require. Frames are mapped in chunks, one per Grow, and
+ * never move, so a Page keeps pointing at its frame while the pool grows and shrinks.
+ *
+ * With huge_pages the chunks are aligned to HUGE_PAGE_SIZE and the kernel is asked to back them with transparent huge
+ * pages, which saves TLB misses on large pools. It is only a hint, the kernel may fall back to regular pages.
+ */
+class FrameArena {
+ public:
+  explicit FrameArena(bool huge_pages = false) : huge_pages_(huge_pages) {}
+
+  ~FrameArena();
+
+  DISALLOW_COPY(FrameArena)
+
+  /**
+   * Append count zeroed frames. The frames left over by an earlier Shrink are used first, the rest comes from a new
+   * chunk, so the frames added to an empty arena are contiguous.
+   */
+  void Grow(size_t count);
+
+  /**
+   * Keep the first count frames. A chunk is unmapped once none of its frames is kept.
+   */
+  void Shrink(size_t count);
+
+  /** @return the data of a frame, valid until the frame is removed by Shrink */
+  char *GetFrame(size_t index) const;
+
+  /** @return number of frames */
+  inline size_t GetSize() const { return size_; }
+
+  /** @return bytes mapped for the frames, including the unused tail of the last chunk */
+  size_t GetMappedBytes() const;
+
+  inline bool UsesHugePages() const { return huge_pages_; }
+
+ private:
+  struct Chunk {
+    size_t first_frame_;  // index of the first frame in the chunk
+    size_t frames_;       // frames that fit into the chunk
+    char *data_;
+    size_t bytes_;
+  };
+
+  bool huge_pages_;
+  size_t size_{0};
+  std::vector<Chunk> chunks_;  // in frame order
+};
+
+#endif  // MINISQL_FRAME_ARENA_H
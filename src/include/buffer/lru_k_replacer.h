@@ -0,0 +1,74 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy (O'Neil et al.).
+ *
+ * Every Pin is one reference at the next logical timestamp. The victim is the evictable frame whose K-th most recent
+ * uncorrelated reference is the oldest, i.e. with the largest backward K-distance. Frames with fewer than K references
+ * have an infinite distance and are evicted first, least recently used first, so pages touched once by a sequential
+ * scan leave the pool before pages that are referenced repeatedly.
+ *
+ * References that arrive within the correlated reference period of the previous one (e.g. the same heap page fetched
+ * once per tuple) are collapsed into a single reference, and frames referenced within that period are not evicted
+ * while any other candidate exists.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of references tracked per frame
+   * @param correlated_period references within this many ticks of the last one are correlated
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = DEFAULT_LRUK_REPLACER_K,
+                        uint64_t correlated_period = DEFAULT_LRUK_CORRELATED_PERIOD);
+
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  struct FrameHistory {
+    std::deque<uint64_t> hist_;  // uncorrelated reference times, most recent first, at most k entries
+    uint64_t last_{0};           // time of the most recent reference, correlated or not
+    bool evictable_{false};
+  };
+
+  /** Record a reference to the frame at the next timestamp. */
+  void RecordAccess(FrameHistory &history);
+
+  /** @return key ordering the frame inside its candidate set, smaller is evicted first */
+  uint64_t EvictionKey(const FrameHistory &history) const;
+
+  std::set<std::pair<uint64_t, frame_id_t>> &CandidateSet(const FrameHistory &history);
+
+  size_t k_;
+  uint64_t correlated_period_;
+  uint64_t current_time_{0};
+  std::unordered_map<frame_id_t, FrameHistory> frames_;
+  std::set<std::pair<uint64_t, frame_id_t>> infinite_;  // evictable frames with fewer than k references
+  std::set<std::pair<uint64_t, frame_id_t>> finite_;    // evictable frames with k references
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
@@ -33,6 +33,8 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) override;
+
   size_t Size() override;
 
 private:
@@ -0,0 +1,89 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several independent BufferPoolManager instances, each with
+ * its own frames, page table, replacer and latch. A page always lives in instance (page_id % num_instances), so
+ * threads working on different pages rarely contend on the same latch.
+ *
+ * It exposes the BufferPoolManager interface, so TableHeap, BPlusTree and CatalogManager can use it unchanged.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @param num_instances number of buffer pool instances
+   * @param pool_size initial number of frames in each instance
+   * @param disk_manager disk manager shared by all instances
+   * @param replacer_type replacement policy of every instance
+   * @param huge_pages back the frames of every instance with transparent huge pages
+   */
+  explicit ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                     ReplacerType replacer_type = ReplacerType::LRU, bool huge_pages = false);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id) override;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  /** Write back the dirty pages of all instances with a single DiskManager::WritePages call. */
+  size_t FlushAllPages() override;
+
+  /**
+   * Allocate a page id on disk first and then create its frame in the instance the id maps to.
+   */
+  Page *NewPage(page_id_t &page_id) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  size_t GetPoolSize() override;
+
+  /**
+   * Spread new_pool_size frames evenly over the instances.
+   * @return false if there are fewer frames than instances
+   */
+  bool Resize(size_t new_pool_size) override;
+
+  void EnableBackgroundCleaner(double clean_fraction, std::chrono::milliseconds interval) override;
+
+  void DisableBackgroundCleaner() override;
+
+  /** @return the counters of all instances added up */
+  BufferPoolStats GetStats() override;
+
+  /** @return the instance responsible for page_id */
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id) { return instances_[page_id % num_instances_]; }
+
+ protected:
+  page_id_t ReadAhead(page_id_t page_id, size_t next_page_id_offset) override;
+
+  frame_id_t ReserveReadAhead(page_id_t page_id, Page **page, bool *busy = nullptr) override;
+
+  /** Interleave the lists of the instances, which each go from the most to the least recently used page. */
+  void GetResidentPages(std::vector<page_id_t> *page_ids) override;
+
+  frame_id_t ReserveFrame(page_id_t page_id, Page **page, bool *pool_full, bool *busy = nullptr) override;
+
+  void FinishReads(const std::vector<std::pair<page_id_t, frame_id_t>> &reads) override;
+
+  Page *NewPageWithId(page_id_t page_id) override;
+
+ private:
+  size_t num_instances_;
+  DiskManager *disk_manager_;
+  std::vector<BufferPoolManager *> instances_;
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
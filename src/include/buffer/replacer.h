@@ -2,9 +2,15 @@
 #define MINISQL_REPLACER_H
 
 #include <cstdio>
+#include <vector>
 
 #include "common/config.h"
 
+/**
+ * Replacement policies a BufferPoolManager can be constructed with.
+ */
+enum class ReplacerType { LRU, CLOCK, LRU_K };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,6 +39,27 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forget a frame whose page has left the buffer pool, e.g. after the page is deleted. The frame is no longer a
+   * victim candidate and any access history kept for it is dropped.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Look at the frames that would be victimized next, without removing them. Used by the background cleaner to write
+   * dirty pages back before they are evicted.
+   * @param num maximum number of frames to return
+   * @param[out] frames victim candidates in eviction order
+   */
+  virtual void GetVictimCandidates(size_t num, std::vector<frame_id_t> *frames) = 0;
+
+  /**
+   * Called when the buffer pool is resized. Frames beyond num_pages have been removed from the replacer beforehand.
+   * @param num_pages the maximum number of pages the replacer will be required to store from now on
+   */
+  virtual void SetCapacity(size_t /*num_pages*/) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -2,6 +2,7 @@
 #define MINISQL_CATALOG_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -94,7 +95,34 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * One step of the compaction of the database file. It frees the pages that no table or index reaches any more, e.g.
+   * those of dropped tables, then moves up to max_pages live pages from the end of the file to the lowest free pages,
+   * fixing the page lists, the tree links, the index entries and the meta pages that point at them. Other statements
+   * may run between steps, so the step size throttles a compaction. The live pages are collected by the first step
+   * and kept for the next ones, unless pages were allocated or freed in between. Once it moves fewer than max_pages
+   * the live pages are at the start of the file, and DiskManager::TruncateFile can shrink it.
+   * @param[out] moved_pages number of pages moved
+   * @param[out] freed_pages number of unreachable pages freed
+   */
+  dberr_t CompactPages(size_t max_pages, size_t *moved_pages, size_t *freed_pages);
+
  private:
+  /** What a page reachable from the catalog belongs to */
+  enum class PageOwner { TABLE_META, INDEX_META, TABLE_HEAP, TABLE_FSM, INDEX };
+
+  /**
+   * @param[out] pages every page reachable from the catalog, apart from the catalog meta and the index roots page, with
+   * its owner and the id of its table or index
+   */
+  void CollectPages(std::map<page_id_t, std::pair<PageOwner, uint32_t>> *pages);
+
+  /**
+   * Collect the live pages for a new compaction, free the unreachable ones and drop the index roots of dropped indexes.
+   * @param[out] freed_pages number of unreachable pages freed
+   */
+  void StartCompaction(size_t *freed_pages);
+
   dberr_t DropTable(table_id_t table_id);
 
   dberr_t FlushCatalogMetaPage() const;
@@ -118,6 +146,16 @@ class CatalogManager {
   // map for indexes: table_name->index_name->indexes
   std::unordered_map<std::string, std::unordered_map<std::string, index_id_t>> index_names_;
   std::unordered_map<index_id_t, IndexInfo *> indexes_;
+
+  /** A compaction between two of its steps */
+  struct CompactionState {
+    // live pages that may still move, with their owners; the step continues from the highest one
+    std::map<page_id_t, std::pair<PageOwner, uint32_t>> pages_;
+    // page allocations and frees of the buffer pool when the last step ended, the pages are stale once they change
+    uint64_t new_pages_{0};
+    uint64_t deleted_pages_{0};
+  };
+  std::unique_ptr<CompactionState> compaction_;
 };
 
 #endif  // MINISQL_CATALOG_H
@@ -27,7 +27,7 @@ class TableMetadata {
    * will create new table schema and owned by mem heap
    */
   static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                               TableSchema *schema);
+                               page_id_t fsm_page_id, TableSchema *schema);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -35,18 +35,27 @@ class TableMetadata {
 
   inline uint32_t GetFirstPageId() const { return root_page_id_; }
 
+  inline void SetFirstPageId(page_id_t first_page_id) { root_page_id_ = first_page_id; }
+
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_page_id_; }
+
+  inline void SetFreeSpaceMapPageId(page_id_t fsm_page_id) { fsm_page_id_ = fsm_page_id; }
+
   inline Schema *GetSchema() const { return schema_; }
 
  private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, page_id_t fsm_page_id,
+                TableSchema *schema);
 
  private:
-  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344529;
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V1 = 344528;  // written before the free space map page id
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
+  page_id_t fsm_page_id_;  // first page of the free space map of the table heap
   Schema *schema_;
 };
 
@@ -13,8 +13,28 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
-static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int PAGE_SIZE = 4096;                       // size of a data page in byte
+static constexpr int HUGE_PAGE_SIZE = 2 * 1024 * 1024;       // size of a transparent huge page in byte
+static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;       // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;      // number of parallel buffer pool instances
+static constexpr int DEFAULT_LRUK_REPLACER_K = 2;            // k of the LRU-K replacer
+static constexpr int DEFAULT_LRUK_CORRELATED_PERIOD = 8;     // accesses within this many ticks count as one reference
+static constexpr int DEFAULT_SCAN_RING_SIZE = 32;            // frames in the private ring of a bulk read
+static constexpr int DEFAULT_CLEANER_INTERVAL_MS = 10;       // interval between two background cleaner rounds
+static constexpr double DEFAULT_CLEAN_FRACTION = 0.1;        // fraction of the buffer pool kept clean ahead of eviction
+static constexpr int DEFAULT_READ_AHEAD_WINDOW = 16;         // upcoming pages iterators keep in flight
+static constexpr int DEFAULT_WARM_UP_READ_PAGES = 32;        // consecutive pages loaded by one warm-up read
+static constexpr int DEFAULT_FILE_GROW_PAGES = 256;          // pages preallocated each time the database file grows
+static constexpr int DEFAULT_SEGMENT_PAGES = 262144;         // pages per segment file of a database, 1 GB
+static constexpr int DEFAULT_GROUP_COMMIT_INTERVAL_MS = 10;  // longest delay before group commit syncs a write
+static constexpr int DEFAULT_GROUP_COMMIT_BATCH = 256;       // writes that make group commit sync without waiting
+static constexpr int DEFAULT_HEAP_GROW_MIN_PAGES = 8;        // fewest contiguous pages a table heap grows by
+static constexpr int DEFAULT_HEAP_GROW_MAX_PAGES = 64;       // most contiguous pages a table heap grows by
+static constexpr int DEFAULT_BULK_INSERT_MIN_ROWS = 64;      // fewest rows an insert appends to fresh heap pages at once
+static constexpr int DEFAULT_INDEX_BULK_LOAD_PAGES = 64;     // contiguous pages allocated at once by an index bulk load
+static constexpr int DEFAULT_COMPACTION_STEP_PAGES = 1024;   // pages moved by one step of a database compaction
+static constexpr int DEFAULT_IO_QUEUE_DEPTH = 64;            // requests an asynchronous I/O engine keeps in flight
+static constexpr int DEFAULT_IO_THREADS = 4;                 // threads of the pread/pwrite fallback I/O engine
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
@@ -22,6 +42,7 @@ static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of var
 // static std::string DB_META_FILE = "minisql.meta.db";
 
 using page_id_t = int32_t;
+using physical_page_id_t = int64_t;  // position of a page in the database file, see DiskManager
 using frame_id_t = int32_t;
 using txn_id_t = int32_t;
 using lsn_t = int32_t;
@@ -14,12 +14,20 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param buffer_pool_size total number of frames, split evenly across buffer_pool_instances
+   * @param buffer_pool_instances use a ParallelBufferPoolManager with this many instances when greater than 1
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES);
 
   ~DBStorageEngine();
 
   std::unique_ptr<ExecuteContext> MakeExecuteContext(Transaction *txn);
 
+  /** @return the file listing the pages to preload when the database is opened again */
+  std::string GetWarmUpFileName() const;
+
  public:
   DiskManager *disk_mgr_;
   BufferPoolManager *bpm_;
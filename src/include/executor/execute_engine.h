@@ -73,6 +73,14 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteShowBufferStatus(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteCheckpoint(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
 
 
  private:
@@ -12,7 +12,8 @@
 /**
  * InsertExecutor executes an insert on a table.
  *
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor. At least DEFAULT_BULK_INSERT_MIN_ROWS of them are loaded
+ * through TableHeap::BulkInsert and Index::BulkLoad, fewer are inserted one at a time.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -42,6 +43,12 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Insert many rows at once: the rows before the first duplicate key are appended to fresh pages of the table, then
+   * each index gets their entries as one sorted batch.
+   */
+  void BulkInsert(std::vector<Row> &rows);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
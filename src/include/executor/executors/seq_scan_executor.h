@@ -40,8 +40,12 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  TableIterator table_iterator;
+  /** Reads the table a page at a time, Next hands out the rows of the current batch */
+  TableBatchIterator batch_iterator_;
+  size_t batch_pos_{0};
   TableInfo* table_info{};
+  /** Private ring of frames so a full scan does not flush the shared buffer pool */
+  BufferAccessStrategy strategy_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
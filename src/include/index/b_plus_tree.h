@@ -1,8 +1,11 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <functional>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "index/index_iterator.h"
@@ -35,6 +38,13 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
+  /**
+   * Build the tree bottom-up from entries sorted by key, without duplicates. Each level is written left to right into
+   * runs of contiguous pages, so that range scans read the leaves sequentially.
+   * @return false if the tree is not empty or the pages could not be allocated; the tree is left as it was then
+   */
+  bool BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
@@ -56,13 +66,30 @@ class BPlusTree {
   // destroy the b plus tree
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
+  /**
+   * @param[out] page_ids every page of the tree, level by level from the root
+   */
+  void GetPageIds(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Move a node to a free page, e.g. to compact the database file. The new page gets a copy of the node, and the
+   * parent, the children, the previous leaf or the index roots page are pointed at it. The caller deletes the old page.
+   */
+  void RelocatePage(page_id_t old_page_id, page_id_t new_page_id);
+
+  /**
+   * Point the entries of rows whose table page was relocated at the new page, one pass over the leaves.
+   * @param moved_pages new page id of every relocated table page
+   */
+  void RelocateRows(const std::unordered_map<page_id_t, page_id_t> &moved_pages);
+
   void PrintTree(std::ofstream &out) {
     if (IsEmpty()) {
       return;
     }
     out << "digraph G {" << std::endl;
     Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    auto *node = reinterpret_cast<BPlusTreePage *>(root_page);
+    auto *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
     ToGraph(node, buffer_pool_manager_, out);
     out << "}" << std::endl;
   }
@@ -70,6 +97,15 @@ class BPlusTree {
  private:
   void StartNewTree(GenericKey *key, const RowId &value);
 
+  /**
+   * Create the nodes of one level of a bulk load, spreading num_items evenly so that no node is below its minimum size.
+   * @param fill sets up a node with the items [begin, end) and returns its first key
+   * @param[out] nodes first key and page id of every node of the level
+   */
+  bool BulkLoadLevel(size_t num_items, size_t max_items,
+                     const std::function<GenericKey *(Page *page, size_t begin, size_t end)> &fill,
+                     std::vector<std::pair<GenericKey *, page_id_t>> *nodes);
+
   bool InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
@@ -11,12 +11,23 @@ class BPlusTreeIndex : public Index {
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  /**
+   * An empty tree is built bottom-up from the sorted entries, otherwise they are inserted one by one in key order.
+   */
+  dberr_t BulkLoad(const std::vector<std::pair<Row, RowId>> &entries, Transaction *txn) override;
+
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
 
   dberr_t Destroy() override;
 
+  void GetPageIds(std::vector<page_id_t> *page_ids) override;
+
+  void RelocatePage(page_id_t old_page_id, page_id_t new_page_id) override;
+
+  void RelocateRows(const std::unordered_map<page_id_t, page_id_t> &moved_pages) override;
+
   IndexIterator GetBeginIterator();
 
   IndexIterator GetBeginIterator(GenericKey *key);
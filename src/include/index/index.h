@@ -2,6 +2,9 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/dberr.h"
 #include "record/row.h"
@@ -15,6 +18,17 @@ class Index {
 
   virtual dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
+  /**
+   * Insert the entries of rows that are already in the table, e.g. when the index is created or after a bulk insert
+   * into the table. Entries whose key is in the index already are skipped.
+   */
+  virtual dberr_t BulkLoad(const std::vector<std::pair<Row, RowId>> &entries, Transaction *txn) {
+    for (auto &entry : entries) {
+      InsertEntry(entry.first, entry.second, txn);
+    }
+    return DB_SUCCESS;
+  }
+
   virtual dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
@@ -22,6 +36,22 @@ class Index {
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * @param[out] page_ids every page of the index, e.g. for the compaction of the database file
+   */
+  virtual void GetPageIds(std::vector<page_id_t> *page_ids) = 0;
+
+  /**
+   * Move a page of the index to a free page and point the index at it. The caller deletes the old page.
+   */
+  virtual void RelocatePage(page_id_t old_page_id, page_id_t new_page_id) = 0;
+
+  /**
+   * Point the entries of rows whose table page was relocated at the new page.
+   * @param moved_pages new page id of every relocated table page
+   */
+  virtual void RelocateRows(const std::unordered_map<page_id_t, page_id_t> &moved_pages) = 0;
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
@@ -36,7 +36,14 @@ class IndexIterator {
   std::pair<GenericKey *, RowId>  data;
   BufferPoolManager *buffer_pool_manager{nullptr};
   KeyManager *Processor;
+  page_id_t read_ahead_page_id_{INVALID_PAGE_ID};  // last leaf ReadAhead was called on
+  size_t read_ahead_pages_{0};                     // leaves already requested ahead of it
   // add your own private member variables here
+
+  /**
+   * Keep the read-ahead window of the buffer pool in flight ahead of the leaf the iterator is on.
+   */
+  void ReadAhead();
 };
 
 #endif  // MINISQL_INDEX_ITERATOR_H
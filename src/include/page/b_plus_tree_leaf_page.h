@@ -28,6 +28,7 @@
 #include "page/b_plus_tree_page.h"
 
 #define LEAF_PAGE_HEADER_SIZE 32
+#define LEAF_PAGE_NEXT_PAGE_ID_OFFSET 28
 #define LEAF_PAGE_SIZE (((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey *, RowId>)) - 1)
 
 class BPlusTreeLeafPage : public BPlusTreePage {
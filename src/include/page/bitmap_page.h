@@ -20,6 +20,13 @@ class BitmapPage {
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate count consecutive pages, taking the first free run that is long enough.
+   * @param page_offset Index in extent of the first page allocated.
+   * @return true if a free run of count pages was found.
+   */
+  bool AllocatePages(uint32_t count, uint32_t &page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -29,8 +36,16 @@ class BitmapPage {
    */
   bool IsPageFree(uint32_t page_offset) const;
 
-      
+
   uint32_t GetNextFreePage() const;
+
+  /**
+   * Scan the bitmap a 64-bit word at a time for a free page.
+   * @param start offset the scan starts from, it wraps around to the beginning of the extent
+   * @return offset of the first free page at or after start, or GetMaxSupportedSize() if the extent is full
+   */
+  uint32_t FindFreePage(uint32_t start) const;
+
  private:
   /**
    * check a bit(byte_index, bit_index) in bytes is free(value 0).
@@ -41,6 +56,18 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * Scan the bitmap a 64-bit word at a time from start to the end of the extent.
+   * @param free whether to look for a free or an allocated page
+   * @return offset of the first such page, or GetMaxSupportedSize() if there is none
+   */
+  uint32_t ScanPages(uint32_t start, bool free) const;
+
+  /**
+   * @return the word_index-th 64 bits of the bitmap, the page with the lowest offset in the most significant bit
+   */
+  uint64_t GetWord(uint32_t word_index) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
@@ -5,7 +5,15 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+/** number of extents whose used page counters fit into the meta page */
+static constexpr uint32_t META_PAGE_EXTENTS = (PAGE_SIZE - 8) / 4;
+
+/** number of extents whose used page counters fit into a directory page */
+static constexpr uint32_t DIRECTORY_PAGE_EXTENTS = PAGE_SIZE / 4;
+
+/** logical page ids stay below this bound, it is the last whole extent that a page_id_t can address */
+static constexpr page_id_t MAX_VALID_PAGE_ID =
+    INT32_MAX / BitmapPage<PAGE_SIZE>::GetMaxSupportedSize() * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 class DiskFileMetaPage {
  public:
@@ -13,8 +21,9 @@ class DiskFileMetaPage {
 
   uint32_t GetAllocatedPages() { return num_allocated_pages_; }
 
+  /** Only covers the first META_PAGE_EXTENTS extents, the others are counted by DiskFileDirectoryPage. */
   uint32_t GetExtentUsedPage(uint32_t extent_id) {
-    if (extent_id >= num_extents_) {
+    if (extent_id >= num_extents_ || extent_id >= META_PAGE_EXTENTS) {
       return 0;
     }
     return extent_used_page_[extent_id];
@@ -26,4 +35,13 @@ class DiskFileMetaPage {
   uint32_t extent_used_page_[0];
 };
 
+/**
+ * Continues the extent directory of DiskFileMetaPage: directory page i holds the used page counters of the
+ * DIRECTORY_PAGE_EXTENTS extents starting at META_PAGE_EXTENTS + i * DIRECTORY_PAGE_EXTENTS.
+ */
+class DiskFileDirectoryPage {
+ public:
+  uint32_t extent_used_page_[DIRECTORY_PAGE_EXTENTS]{};
+};
+
 #endif  // MINISQL_DISK_FILE_META_PAGE_H
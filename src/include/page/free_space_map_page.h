@@ -0,0 +1,73 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * Free space map page, records the room left on the pages of a table heap. The map of a heap is a list of these pages
+ * with one entry per heap page, in the order of the heap's page list. The room is kept in coarse buckets of
+ * BUCKET_SIZE bytes, rounded down, so a page whose bucket covers a tuple always has room for it.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | PageId_1 (4) | ... | PageId_n (4) | Bucket_1 (1) | ... | Bucket_n (1) |
+ *  ----------------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - 8) / (sizeof(page_id_t) + 1);
+  static constexpr uint32_t BUCKET_SIZE = PAGE_SIZE / 256;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t GetEntryCount() const { return count_; }
+
+  inline bool IsFull() const { return count_ == MAX_ENTRY_COUNT; }
+
+  /** Append the entry of a heap page, the page must not be full */
+  void Append(page_id_t page_id, uint8_t bucket) {
+    page_ids_[count_] = page_id;
+    buckets_[count_] = bucket;
+    count_++;
+  }
+
+  inline page_id_t GetPageIdAt(uint32_t i) const { return page_ids_[i]; }
+
+  inline void SetPageIdAt(uint32_t i, page_id_t page_id) { page_ids_[i] = page_id; }
+
+  inline uint8_t GetBucketAt(uint32_t i) const { return buckets_[i]; }
+
+  inline void SetBucketAt(uint32_t i, uint8_t bucket) { buckets_[i] = bucket; }
+
+  /** @return index of the first entry with at least the given bucket, GetEntryCount() if there is none */
+  uint32_t FindBucket(uint8_t bucket) const;
+
+  /** @return the largest bucket of the entries, 0 if there are none */
+  uint8_t GetMaxBucket() const;
+
+  /** @return the bucket of a page with free_space bytes left */
+  static inline uint8_t ToBucket(uint32_t free_space) { return std::min<uint32_t>(free_space / BUCKET_SIZE, 255); }
+
+  /** @return the least bucket that guarantees size bytes of room */
+  static inline uint8_t ToBucketRoundUp(uint32_t size) { return (size + BUCKET_SIZE - 1) / BUCKET_SIZE; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  page_id_t page_ids_[MAX_ENTRY_COUNT];
+  uint8_t buckets_[MAX_ENTRY_COUNT];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= PAGE_SIZE, "A free space map page must fit into a page");
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
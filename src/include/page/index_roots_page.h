@@ -29,6 +29,8 @@ class IndexRootsPage {
 
   int GetIndexCount() { return count_; }
 
+  index_id_t GetIndexIdAt(int i) { return roots_[i].first; }
+
  private:
   static constexpr int MAX_INDEX_COUNT = (PAGE_SIZE - 4) / 8;
 
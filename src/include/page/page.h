@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 
 #include "common/config.h"
@@ -20,8 +21,11 @@ class Page {
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor of a page outside of any buffer pool. Owns its data and zeros it out. */
+  Page() : owned_data_(new char[PAGE_SIZE]()), data_(owned_data_.get()) {}
+
+  /** Constructor of a buffer pool frame, whose data is a zeroed frame of the pool's FrameArena. */
+  explicit Page(char *data) : data_(data) {}
 
   /** Default destructor. */
   ~Page() = default;
@@ -68,8 +72,10 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
+  /** The data of a page that is not a buffer pool frame. */
+  std::unique_ptr<char[]> owned_data_;
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  char *data_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
@@ -18,11 +18,13 @@
  **/
 
 #include <cstring>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -33,6 +35,8 @@ class TablePage : public Page {
 
   page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
+  void SetTablePageId(page_id_t page_id) { memcpy(GetData(), &page_id, sizeof(page_id_t)); }
+
   page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
 
   page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
@@ -58,10 +62,22 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Decode every live tuple of the page in slot order, reusing the rows already in the vector.
+   * @param filter if set, only the tuples it accepts are decoded, it sees each tuple through a RowView over the page
+   * @return the number of rows decoded, rows past it are left over from earlier calls
+   */
+  size_t GetTuples(std::vector<Row> *rows, Schema *schema, const RowFilter &filter = nullptr);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /** @return bytes left for tuples and their slots */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -73,9 +89,6 @@ class TablePage : public Page {
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
 
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -103,16 +116,16 @@ class TablePage : public Page {
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
-  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
   static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
 
  public:
+  static constexpr size_t SIZE_TUPLE = 8;  // slot of a tuple, its offset and size
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
 };
 
 #endif
\ No newline at end of file
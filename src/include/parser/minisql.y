@@ -1,5 +1,6 @@
 %{
   #include <stdio.h>
+  #include <strings.h>
   #include "parser/parser.h"
 
   extern char *yytext;
@@ -7,6 +8,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -26,8 +29,9 @@
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
-%type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_insert insert_rows insert_row sql_delete sql_update update_values update_value
+%type <syntax_node> sql_quit sql_exec_file sql_show_buffer_status sql_set_variable
+%type <syntax_node> sql_checkpoint sql_vacuum
 
 %%
 
@@ -58,6 +62,10 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_show_buffer_status { $$ = $1; }
+  | sql_set_variable { $$ = $1; }
+  | sql_checkpoint { $$ = $1; }
+  | sql_vacuum { $$ = $1; }
   ;
 
 sql_create_database:
@@ -195,6 +203,49 @@ sql_show_indexes:
   }
   ;
 
+sql_show_buffer_status:
+  SHOW IDENTIFIER IDENTIFIER {
+    if (strcasecmp($2->val_, "buffer") != 0 || strcasecmp($3->val_, "status") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeShowBufferStatus, NULL);
+  }
+  ;
+
+sql_checkpoint:
+  IDENTIFIER {
+    if (strcasecmp($1->val_, "checkpoint") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeCheckpoint, NULL);
+  }
+  ;
+
+sql_vacuum:
+  IDENTIFIER IDENTIFIER {
+    if (strcasecmp($1->val_, "vacuum") != 0 || strcasecmp($2->val_, "full") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeVacuum, NULL);
+  }
+  ;
+
+sql_set_variable:
+  SET IDENTIFIER EQ NUMBER {
+    $$ = CreateSyntaxNode(kNodeSetVariable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddSibling($2, $4);
+  }
+  | SET IDENTIFIER EQ IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeSetVariable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddSibling($2, $4);
+  }
+  ;
+
 sql_select:
   SELECT select_columns FROM IDENTIFIER {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
@@ -289,12 +340,37 @@ operator:
   ;
 
 sql_insert:
-  INSERT INTO IDENTIFIER VALUES '(' column_values ')' {
+  INSERT INTO IDENTIFIER VALUES insert_rows {
     $$ = CreateSyntaxNode(kNodeInsert, NULL);
     SyntaxNodeAddChildren($$, $3);
-    pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
-    SyntaxNodeAddChildren(col_val_node, $6);
-    SyntaxNodeAddChildren($$, col_val_node);
+    /* insert_rows links the rows last to first, put them back in order */
+    pSyntaxNode rows = NULL;
+    while ($5 != NULL) {
+      pSyntaxNode next = $5->next_;
+      $5->next_ = rows;
+      rows = $5;
+      $5 = next;
+    }
+    SyntaxNodeAddChildren($$, rows);
+  }
+  ;
+
+insert_rows:
+  insert_rows ',' insert_row {
+    /* left recursive with the last row first, so that a long list neither deepens the parser stack nor is walked to
+       append each row */
+    $$ = $3;
+    $$->next_ = $1;
+  }
+  | insert_row {
+    $$ = $1;
+  }
+  ;
+
+insert_row:
+  '(' column_values ')' {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -43,7 +43,11 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin transaction command */
   kNodeTrxCommit,            /** commit transaction command */
-  kNodeTrxRollback           /** rollback transaction command */
+  kNodeTrxRollback,          /** rollback transaction command */
+  kNodeShowBufferStatus,     /** show buffer status command */
+  kNodeSetVariable,          /** set variable command, eg: set buffer_pool_size = 4096, set durability = group_commit */
+  kNodeCheckpoint,           /** checkpoint command, writes back every dirty page */
+  kNodeVacuum                /** vacuum full command, compacts the database file */
 } SyntaxNodeType;
 
 /**
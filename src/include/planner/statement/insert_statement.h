@@ -14,8 +14,14 @@ class InsertStatement : public AbstractStatement {
 
   /** Transfer syntax tree to statement. */
   void SyntaxTree2Statement(pSyntaxNode ast) {
-    if (!ast)
-      return;
+    // a loop over the siblings rather than recursion, a multi-row insert has one sibling per row
+    for (; ast; ast = ast->next_) {
+      SyntaxNode2Statement(ast);
+    }
+  };
+
+  /** Transfer one node of the syntax tree. */
+  void SyntaxNode2Statement(pSyntaxNode ast) {
     switch (ast->type_) {
       case kNodeIdentifier: {
         TableInfo *info = nullptr;
@@ -34,8 +40,7 @@ class InsertStatement : public AbstractStatement {
       default:
         throw std::logic_error("the ast_type is not supported in planner yet");
     }
-    SyntaxTree2Statement(ast->next_);
-  };
+  }
 
   void MakeInsertValues(pSyntaxNode ast) {
     std::vector<AbstractExpressionRef> value;
@@ -19,10 +19,20 @@
  * | Field Nums | Null bitmap |
  * -------------------------------------------
  *
- *
+ *  The top byte of Field Nums holds the format version. Version 0 stores the non-null fields one after another, so
+ *  reaching a field decodes all the fields in front of it. Version 1 is written from now on, with every field at an
+ *  offset the Schema computes once from the column types:
+ * ---------------------------------------------------------------------------------------------------
+ * | Header | Int/Float-1 | ... | Int/Float-M | Char End-1 | ... | Char End-K | Char Data-1 | ... | Char Data-K |
+ * ---------------------------------------------------------------------------------------------------
+ *  Int and float fields take 4 bytes each, null ones too. Char End-i is the offset in the row where the data of the
+ *  i-th CHAR field ends; its data starts where the previous one ends, or after the offset table for the first.
  */
 class Row {
  public:
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr uint32_t FIELD_NUM_MASK = 0x00ffffff;
+
   /**
    * Row used for insert
    * Field integrity should check by upper level
@@ -87,7 +97,7 @@ class Row {
 
   /**
    * For empty row, return 0
-   * For non-empty row with null fields, eg: |null|null|null|, return header size only
+   * For non-empty row with null fields, eg: |null|null|null|, return Schema::GetRowFixedSize()
    * @return
    */
   uint32_t GetSerializedSize(Schema *schema) const;
@@ -108,6 +118,9 @@ class Row {
   inline size_t GetFieldCount() const { return fields_.size(); }
 
  private:
+  /** Read a row in the fixed-offset format of version 1 */
+  uint32_t DeserializeFixedOffset(char *buf, Schema *schema);
+
   RowId rid_{};
   std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
 };
@@ -0,0 +1,62 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <functional>
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a row in its serialized form, e.g. a tuple on a pinned table page, to evaluate a predicate without
+ * materializing the row. Reset reads the header of the tuple once, locating its null bitmap and, for the sequential
+ * format of version 0, the offset of every column; the fixed-offset format takes them from the Schema. GetField
+ * decodes only the column asked for, a CHAR field points into the tuple instead of copying it.
+ * The view and the fields it returns are valid as long as the tuple bytes are, i.e. while the page stays pinned.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  RowView(const char *data, Schema *schema, RowId rid = INVALID_ROWID) { Reset(data, schema, rid); }
+
+  /**
+   * Point the view at another serialized row, reusing the offset table of the previous one.
+   */
+  void Reset(const char *data, Schema *schema, RowId rid = INVALID_ROWID);
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline size_t GetFieldCount() const { return field_num_; }
+
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_num_, "Failed to access field");
+    return (null_bitmap_[idx / 8] & (0x80 >> (idx % 8))) == 0;
+  }
+
+  /**
+   * Decode a single column, a CHAR field does not own its data and points into the serialized row.
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Decode every column into a row that owns its fields.
+   */
+  void Materialize(Row *row) const;
+
+ private:
+  const char *data_{nullptr};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+  uint32_t field_num_{0};
+  bool fixed_offset_{false};          // whether the row is in the fixed-offset format, see Row
+  const char *null_bitmap_{nullptr};  // a set bit marks a non-null column, the most significant bit first
+  std::vector<uint32_t> offsets_;     // offset of each column from data_ in the sequential format, unused for nulls
+};
+
+/** Predicate evaluated against a tuple before it is materialized, see TablePage::GetTuples */
+using RowFilter = std::function<bool(const RowView &)>;
+
+#endif  // MINISQL_ROW_VIEW_H
@@ -13,7 +13,9 @@
 class Schema {
  public:
   explicit Schema(const std::vector<Column *> columns, bool is_manage_ = true)
-      : columns_(std::move(columns)), is_manage_(is_manage_) {}
+      : columns_(std::move(columns)), is_manage_(is_manage_) {
+    ComputeRowLayout();
+  }
 
   ~Schema() {
     if (is_manage_) {
@@ -80,10 +82,28 @@ class Schema {
    */
   static uint32_t DeserializeFrom(char *buf, Schema *&schema);
 
+  /**
+   * Layout of the fixed-offset row format, see Row::SerializeTo.
+   * @return offset in a row of the value of a fixed-width column, or of the end offset of a CHAR column's data
+   */
+  inline uint32_t GetFieldOffset(const uint32_t column_index) const { return field_offsets_[column_index]; }
+
+  /** @return offset in a row of the first entry of its CHAR offset table */
+  inline uint32_t GetCharOffsetTableOffset() const { return char_table_offset_; }
+
+  /** @return bytes of a row in front of its CHAR data */
+  inline uint32_t GetRowFixedSize() const { return row_fixed_size_; }
+
  private:
+  /** Compute the offsets of the fixed-offset row format from the column types */
+  void ComputeRowLayout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  std::vector<uint32_t> field_offsets_;
+  uint32_t char_table_offset_{0};
+  uint32_t row_fixed_size_{0};
 };
 
 using IndexSchema = Schema;
@@ -2,15 +2,57 @@
 #define DISK_MGR_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/io_engine.h"
+
+/**
+ * How DiskManager accesses the database file.
+ * FSTREAM: a single std::fstream, every page access is serialized by a latch.
+ * POSITIONAL: a file descriptor with pread/pwrite, page accesses run concurrently.
+ * MMAP: the file is mapped read-only, reads copy from the mapping and GetPagePointer hands out pointers into it. Page
+ * allocation is rejected, and so is writing a page with contents that differ from the file. For read-mostly databases
+ * that are opened for reporting only.
+ * DIRECT: like POSITIONAL, with the file opened O_DIRECT so that pages bypass the OS page cache and are cached once, in
+ * the buffer pool. Buffers should be aligned to PAGE_SIZE like the frames of the buffer pool, an unaligned buffer is
+ * copied through an aligned one. Falls back to POSITIONAL if the file system does not support O_DIRECT.
+ */
+enum class DiskIOBackend { FSTREAM, POSITIONAL, MMAP, DIRECT };
+
+/**
+ * When the writes of DiskManager are made durable with fdatasync.
+ * SYNC_EVERY_WRITE: after every page write, the meta page is written back on every allocation.
+ * GROUP_COMMIT: a background thread syncs the writes of the last interval, or earlier once a batch of writes is pending.
+ * OS_BUFFERED: only on Sync() and Close(), the OS writes the pages back whenever it sees fit.
+ * Except with SYNC_EVERY_WRITE the meta page and the extent bitmaps are kept in memory and written back by Sync(), so
+ * after a crash the pages allocated since the last sync are free again.
+ */
+enum class DurabilityMode { SYNC_EVERY_WRITE, GROUP_COMMIT, OS_BUFFERED };
+
+/**
+ * An asynchronous read or write of one logical page, see DiskManager::SubmitPageIO.
+ */
+struct PageIORequest {
+  page_id_t page_id_{INVALID_PAGE_ID};
+  char *data_{nullptr};
+  bool write_{false};
+  /** Called once the page is read or written, from an I/O thread unless the stream backend is used. */
+  std::function<void()> callback_;
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +61,28 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * The meta page counts the used pages of the first META_PAGE_EXTENTS extents. A directory page counts those of the
+ * next DIRECTORY_PAGE_EXTENTS extents each, and sits right before the bitmap of the first extent it covers:
+ *      ... | Page 1022N | Directory Page 1 | Free Page BitMap 1023 | ... | Directory Page 2 | ...
+ * Logical page ids stay below MAX_VALID_PAGE_ID, about 8 TB, physical positions and file offsets are 64-bit. The file
+ * is sparse, an extent that was never touched takes no space on disk.
+ *
+ * The physical pages are split into segment files of segment_pages pages each: db_file holds the first segment, and
+ * segment i is the hidden file .<name>.i next to it. Every segment has its own file descriptor and grows on its own,
+ * and a segment may be moved to another mount point and replaced by a symbolic link. Once the pages of a dropped table
+ * or index are free on disk, their space is handed back to the file system by punching holes into the segments.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param segment_pages pages per segment file, at least BITMAP_SIZE; 0 keeps the database in a single file. A database
+   * that already has several segments keeps its segment size, one whose file is larger than a segment stays a single file.
+   * The stream backend works on a single file, and falls back to POSITIONAL for a database that has several segments.
+   */
+  explicit DiskManager(const std::string &db_file, DiskIOBackend backend = DiskIOBackend::POSITIONAL,
+                       DurabilityMode durability_mode = DurabilityMode::OS_BUFFERED,
+                       size_t segment_pages = DEFAULT_SEGMENT_PAGES);
 
   ~DiskManager() {
     if (!closed) {
@@ -30,24 +90,101 @@ class DiskManager {
     }
   }
 
+  /**
+   * Switch the durability mode. The writes done so far are synced first.
+   * @param sync_interval longest delay before a write is synced under GROUP_COMMIT
+   * @param sync_batch number of pending writes that makes GROUP_COMMIT sync before the interval is over
+   */
+  void SetDurabilityMode(DurabilityMode durability_mode,
+                         std::chrono::milliseconds sync_interval = std::chrono::milliseconds(
+                             DEFAULT_GROUP_COMMIT_INTERVAL_MS),
+                         size_t sync_batch = DEFAULT_GROUP_COMMIT_BATCH);
+
+  inline DurabilityMode GetDurabilityMode() const { return durability_mode_; }
+
+  /** @return pages per segment file, 0 if the database is a single file */
+  inline size_t GetSegmentPages() const { return segment_pages_; }
+
+  /** @return name of a segment file of the database, db_file itself for segment 0 */
+  static std::string GetSegmentFileName(const std::string &db_file, size_t index);
+
+  /** Delete the files of a database that is not open. */
+  static void RemoveDatabaseFiles(const std::string &db_file);
+
+  /** @return the backend in use, POSITIONAL if DIRECT was asked for but is not supported */
+  inline DiskIOBackend GetBackend() const { return backend_; }
+
+  /**
+   * Write back the meta page and the extent bitmaps if needed and make every write done so far durable
+   */
+  void Sync();
+
   /**
    * Read page from specific page_id
    * Note: page_id = 0 is reserved for free page bit map
    */
   void ReadPage(page_id_t logical_page_id, char *page_data);
 
+  /**
+   * Point into the mapped file, without copying the page. Only with the MMAP backend.
+   * @return the page, or a page of zeros if it lies beyond the end of the file; valid until Close()
+   */
+  const char *GetPagePointer(page_id_t logical_page_id);
+
+  /**
+   * Read count pages with consecutive logical ids into page_data, one request per extent they span
+   */
+  void ReadPages(page_id_t first_logical_page_id, size_t count, char *page_data);
+
   /**
    * Write data to specific page
    * Note: page_id = 0 is reserved for free page bit map
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Write a batch of pages, e.g. for a checkpoint. The pages are sorted by their position in the file and each run of
+   * adjacent pages is a single vectored write; the runs go through the asynchronous I/O engine together and this
+   * returns once they have completed. The batch counts as one write for the durability mode, so SYNC_EVERY_WRITE syncs
+   * once at the end; with the other modes call Sync() to make it durable.
+   * @param pages logical page id and data of each page
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages);
+
+  /**
+   * Read and write pages through the asynchronous I/O engine, keeping up to its queue depth in flight. The buffers
+   * must stay valid until the callbacks ran. With the stream backend the requests are carried out before this returns.
+   */
+  void SubmitPageIO(std::vector<PageIORequest> requests);
+
+  /**
+   * Wait until every page I/O submitted so far has completed.
+   */
+  void WaitForPageIO();
+
+  /**
+   * Replace the asynchronous I/O engine, after the I/O submitted so far has completed.
+   * It is created on first use with io_uring if available, otherwise with a pread/pwrite thread pool.
+   */
+  void SetIOEngine(IOEngineType type, size_t queue_depth = DEFAULT_IO_QUEUE_DEPTH);
+
+  /**
+   * @return the asynchronous I/O engine, nullptr with the stream backend
+   */
+  IOEngine *GetIOEngine();
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate count pages that are contiguous in the file, i.e. a run of free pages inside one extent
+   * @return logical page id of the first page, INVALID_PAGE_ID if count is 0 or exceeds BITMAP_SIZE
+   */
+  page_id_t AllocatePages(size_t count);
+
   /**
    * Free this page and reset bit map
    */
@@ -58,6 +195,20 @@ class DiskManager {
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * @return the highest allocated logical page id, INVALID_PAGE_ID if no page is allocated
+   */
+  page_id_t GetLastAllocatedPageId();
+
+  /**
+   * Sync, then cut the database files off after the last allocated page, e.g. once a compaction moved the live pages
+   * to the start of the file. Segment files past it are deleted. The pages cut off read as zeros, as do the bitmap and
+   * directory pages of the extents without allocated pages, so no bookkeeping changes. Nothing must read or write a
+   * free page meanwhile.
+   * @return number of bytes the files shrank by
+   */
+  size_t TruncateFile();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -72,34 +223,186 @@ class DiskManager {
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
  private:
+  /**
+   * One file of the database, see the segment layout above.
+   */
+  struct Segment {
+    int fd_{-1};
+    // size of the file including preallocated space, reads beyond it return zeros without touching the file
+    std::atomic<size_t> file_size_{0};
+    // the whole file mapped read-only with the MMAP backend, file_size_ bytes long
+    char *mapping_{nullptr};
+    // written to since the last fdatasync
+    std::atomic<bool> unsynced_{false};
+    // serializes growing the file
+    std::mutex grow_latch_;
+  };
+
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  int64_t GetFileSize(const std::string &file_name);
+
+  /**
+   * Open the file of a segment, creating it if needed, and publish it in segments_. The caller holds db_io_latch_.
+   * @return nullptr if the file does not exist and create is false
+   */
+  Segment *OpenSegment(size_t index, bool create);
+
+  /**
+   * @param[out] offset position of the page in the file of its segment
+   * @return the segment holding the physical page, nullptr if the segment has no file yet
+   */
+  Segment *LocateSegment(physical_page_id_t physical_page_id, size_t *offset);
+
+  /**
+   * @return number of pages from physical_page_id to the end of its segment, count at most
+   */
+  size_t PagesInSegment(physical_page_id_t physical_page_id, size_t count) const;
+
+  /**
+   * Make the segment holding the physical page large enough for it, preallocating DEFAULT_FILE_GROW_PAGES pages at a
+   * time. A new segment file fills up the segments before it, so that the first file tells the segment size.
+   * @param[out] offset position of the page in the file of its segment, if not nullptr
+   * @return the segment holding the page, nullptr if its file could not be created
+   */
+  Segment *GrowFile(physical_page_id_t physical_page_id, size_t *offset = nullptr);
+
+  /**
+   * fdatasync every segment written to since its last sync
+   */
+  void SyncSegments();
+
+  /**
+   * Hand the space of the freed pages in pending_holes_ back to the file system. The caller holds db_io_latch_, and
+   * the bitmaps that free them are durable.
+   */
+  void PunchHoles();
+
+  /**
+   * Write the meta page back now or leave it to Sync(), depending on the durability mode
+   */
+  void WriteMetaPage();
+
+  /**
+   * @return the bitmap of the extent, read from disk and cached on first use
+   */
+  BitmapPage<PAGE_SIZE> *GetExtentBitmap(uint32_t extent_id);
+
+  /**
+   * Write the bitmap of the extent back now or leave it to Sync(), depending on the durability mode
+   */
+  void WriteExtentBitmap(uint32_t extent_id);
+
+  /**
+   * @return the used page counter of the extent, in the meta page or in a directory page read on first use
+   */
+  uint32_t *GetExtentUsedPages(uint32_t extent_id);
+
+  /**
+   * Write the directory entry of the extent back now or leave it to Sync(), depending on the durability mode
+   */
+  void WriteExtentUsedPages(uint32_t extent_id);
+
+  /**
+   * @return physical page id of the bitmap of the extent
+   */
+  static physical_page_id_t BitmapPhysicalPageId(uint32_t extent_id) {
+    physical_page_id_t directory_pages =
+        extent_id < META_PAGE_EXTENTS ? 0 : (extent_id - META_PAGE_EXTENTS) / DIRECTORY_PAGE_EXTENTS + 1;
+    return 1 + static_cast<physical_page_id_t>(extent_id) * (BITMAP_SIZE + 1) + directory_pages;
+  }
+
+  /**
+   * @return physical page id of a directory page, right before the bitmap of the first extent it covers
+   */
+  static physical_page_id_t DirectoryPhysicalPageId(uint32_t index) {
+    return BitmapPhysicalPageId(META_PAGE_EXTENTS + index * DIRECTORY_PAGE_EXTENTS) - 1;
+  }
+
+  /**
+   * Account for count page writes according to the durability mode
+   */
+  void AfterWrite(size_t count = 1);
+
+  void StopSyncer();
 
   /**
    * Read physical page from disk
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  void ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data);
+
+  /**
+   * Read count consecutive physical pages from disk
+   */
+  void ReadPhysicalPages(physical_page_id_t first_physical_page_id, size_t count, char *page_data);
 
   /**
    * Write data to physical page in disk
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  void WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data);
+
+  /**
+   * Hand requests to the asynchronous I/O engine, creating it on first use. The caller holds io_engine_latch_.
+   */
+  void SubmitIORequests(std::vector<IORequest> requests);
 
   /**
    * Map logical page id to physical page id
    */
-  page_id_t MapPageId(page_id_t logical_page_id);
+  physical_page_id_t MapPageId(page_id_t logical_page_id);
+
+  /**
+   * @return true if pages are accessed through db_fd_ with pread/pwrite
+   */
+  inline bool IsPositional() const {
+    return backend_ == DiskIOBackend::POSITIONAL || backend_ == DiskIOBackend::DIRECT;
+  }
+
+  /**
+   * Lock db_io_latch_ for a page access if the backend needs it. pread/pwrite carry their own offset, so only the
+   * stream backend serializes page reads and writes; allocation always holds the latch.
+   */
+  std::unique_lock<std::recursive_mutex> LockPageIO();
 
  private:
   // stream to write db file
   std::fstream db_io_;
+  // pages per segment file, 0 if the database is a single file
+  size_t segment_pages_;
+  // the files of the database, sized for the largest database so that page accesses look a segment up without a
+  // latch; a segment is published once its file is open, under db_io_latch_
+  std::unique_ptr<std::atomic<Segment *>[]> segments_;
+  size_t max_segments_{1};
+  // freed pages whose space is handed back to the file system by the next sync, protected by db_io_latch_
+  std::vector<page_id_t> pending_holes_;
+  DiskIOBackend backend_;
   std::string file_name_;
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  alignas(PAGE_SIZE) char meta_data_[PAGE_SIZE];
+  std::atomic<bool> meta_dirty_{false};
+  // extent bitmaps, protected by db_io_latch_ and written back like the meta page
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  // directory pages beyond the meta page, protected by db_io_latch_ and written back like the meta page
+  std::vector<std::unique_ptr<DiskFileDirectoryPage>> directory_pages_;
+  std::vector<bool> directory_dirty_;
+  // no extent before it has a free page
+  uint32_t first_free_extent_{0};
+  // group commit
+  std::atomic<DurabilityMode> durability_mode_;
+  std::chrono::milliseconds sync_interval_{DEFAULT_GROUP_COMMIT_INTERVAL_MS};
+  std::atomic<size_t> sync_batch_{DEFAULT_GROUP_COMMIT_BATCH};
+  std::atomic<size_t> unsynced_writes_{0};
+  std::thread syncer_;
+  bool syncer_running_{false};  // protected by sync_latch_
+  std::mutex sync_latch_;
+  std::condition_variable sync_cv_;
+  // asynchronous page I/O, created on first use, protected by io_engine_latch_
+  std::unique_ptr<IOEngine> io_engine_;
+  std::mutex io_engine_latch_;
 };
 
 #endif
\ No newline at end of file
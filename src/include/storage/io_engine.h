@@ -0,0 +1,127 @@
+#ifndef MINISQL_IO_ENGINE_H
+#define MINISQL_IO_ENGINE_H
+
+#include <sys/uio.h>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * Which engine carries out asynchronous file I/O.
+ * THREAD_POOL: a few threads doing blocking pread/pwrite, works everywhere.
+ * IO_URING: submission and completion rings shared with the kernel, so a single thread keeps many requests in flight.
+ */
+enum class IOEngineType { THREAD_POOL, IO_URING };
+
+/**
+ * One read or write of a contiguous range of the file, into or from one buffer or, if iov_ is set, several.
+ */
+struct IORequest {
+  int fd_{-1};  // file to access, -1 for the file the engine was created on
+  bool write_{false};
+  size_t offset_{0};
+  char *data_{nullptr};
+  size_t size_{0};
+  /** Buffers the range is scattered over in file order, at most IOV_MAX; data_ is unused then and size_ their total. */
+  std::vector<iovec> iov_;
+  /** Called from an I/O thread once the request is done, with false on an I/O error. Must not wait for the engine. */
+  std::function<void(bool)> callback_;
+};
+
+/**
+ * Counts the requests of one batch that are still in flight, so that whoever submitted them waits for them alone
+ * rather than draining the whole engine.
+ */
+class IOBatch {
+ public:
+  /** Count count more requests, before they are submitted. */
+  void Add(size_t count) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    pending_ += count;
+  }
+
+  /** Count a request as done, e.g. from its callback. */
+  void Done() {
+    // notify under the latch, the waiter may destroy the batch as soon as it sees the count drop to zero
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (--pending_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  /** Wait until every request counted so far is done. */
+  void Wait() {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [this]() { return pending_ == 0; });
+  }
+
+ private:
+  std::mutex latch_;
+  std::condition_variable cv_;
+  size_t pending_{0};  // protected by latch_
+};
+
+/**
+ * IOEngine submits batches of reads and writes on a file descriptor, or on the one a request names, and reports their
+ * completion through callbacks.
+ * At most queue_depth requests are in flight, Submit blocks until there is room for the next one. A read that reaches
+ * beyond the end of the file fills the rest of its buffer with zeros.
+ */
+class IOEngine {
+ public:
+  /**
+   * Create an engine of the given type on fd. Falls back to THREAD_POOL if the kernel does not support io_uring.
+   */
+  static std::unique_ptr<IOEngine> Create(int fd, IOEngineType type, size_t queue_depth = DEFAULT_IO_QUEUE_DEPTH);
+
+  virtual ~IOEngine() = default;
+
+  /**
+   * Queue a batch of requests, the engine keeps them until they complete.
+   */
+  virtual void Submit(std::vector<IORequest> requests) = 0;
+
+  /**
+   * Wait until every request submitted so far has completed.
+   */
+  void Drain();
+
+  virtual IOEngineType GetType() const = 0;
+
+  inline size_t GetQueueDepth() const { return queue_depth_; }
+
+ protected:
+  IOEngine(int fd, size_t queue_depth) : fd_(fd), queue_depth_(queue_depth) {}
+
+  /**
+   * Count a request as in flight, waiting for room in the queue if wait is true.
+   * @return false if the queue is full and wait is false
+   */
+  bool AcquireSlot(bool wait = true);
+
+  /**
+   * Run the callback of a finished request and release its slot.
+   */
+  void Complete(IORequest &request, bool ok);
+
+  /**
+   * Carry out the rest of a request with blocking pread/pwrite, starting done bytes into it.
+   * @return false on an I/O error
+   */
+  bool FinishBlocking(IORequest &request, size_t done);
+
+  int fd_;
+  size_t queue_depth_;
+
+ private:
+  std::mutex slot_latch_;
+  std::condition_variable slot_cv_;
+  size_t in_flight_{0};  // protected by slot_latch_
+};
+
+#endif  // MINISQL_IO_ENGINE_H
@@ -1,7 +1,12 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
 #include "page/header_page.h"
 #include "page/table_page.h"
 #include "storage/table_iterator.h"
@@ -10,6 +15,7 @@
 
 class TableHeap {
   friend class TableIterator;
+  friend class TableBatchIterator;
 
  public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
@@ -17,21 +23,36 @@ class TableHeap {
     return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
   }
 
+  /**
+   * Open an existing heap. A heap opened without its free space map builds one on first use, walking its pages once,
+   * the caller keeps GetFreeSpaceMapPageId() to open it with the map the next time.
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           page_id_t fsm_page_id = INVALID_PAGE_ID) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, fsm_page_id);
   }
 
   ~TableHeap() {}
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The first page with room for it is found through the free space map, the heap grows when no page has room.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Append rows to fresh pages at the end of the table, e.g. to load data. The rows are packed into pages up front, the
+   * pages are filled in page id order as they are allocated in runs of contiguous pages, and each run is linked into
+   * the page list at once. The room left on the existing pages is not used.
+   * @param[in/out] rows Rows to insert, the rid of each inserted row is wrapped in it
+   * @return true iff every row was inserted, nothing is inserted if a row is too large for a page
+   */
+  bool BulkInsert(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -89,21 +110,102 @@ class TableHeap {
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param strategy ring the iterator fetches heap pages through, e.g. for a full scan of a large table
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Transaction *txn);
+  TableIterator Begin(Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * @return the end iterator of this table
    */
   TableIterator End();
 
+  /**
+   * @param strategy ring the iterator fetches heap pages through, e.g. for a full scan of a large table
+   * @param filter if set, only the rows it accepts are decoded, e.g. the rows that match a scan predicate
+   * @return an iterator that reads the rows of this table a page at a time
+   */
+  TableBatchIterator BeginBatch(BufferAccessStrategy *strategy = nullptr, RowFilter filter = nullptr) {
+    return TableBatchIterator(this, strategy, std::move(filter));
+  }
+
   /**
    * @return the id of the first page of this table
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @param[out] page_ids the pages of the heap in list order
+   */
+  void GetPageIds(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Count the pages that follow page_id in the page list and also directly follow it in the file, so that a scan reads
+   * them as one range. Known from the free space map, whose entries are in list order; 0 if the heap has none yet.
+   * @param max_count stop counting at this many pages
+   */
+  size_t GetContiguousPages(page_id_t page_id, size_t max_count);
+
+  /**
+   * Move a page of the heap to a free page, e.g. to compact the database file. The new page gets a copy of the old one
+   * and takes its place in the page list. The rows on it change their row ids, the caller updates the indexes and
+   * deletes the old page.
+   */
+  void RelocatePage(page_id_t old_page_id, page_id_t new_page_id);
+
+  /**
+   * @return the id of the first page of the free space map of this table
+   */
+  page_id_t GetFreeSpaceMapPageId();
+
+  /**
+   * @param[out] page_ids the pages of the free space map in list order
+   */
+  void GetFreeSpaceMapPageIds(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Move a page of the free space map to a free page, the caller deletes the old page.
+   */
+  void RelocateFreeSpaceMapPage(page_id_t old_page_id, page_id_t new_page_id);
+
 private:
+  /**
+   * Read the free space map into memory, or build it if the heap has none.
+   * @return false if the map could not be built for want of a page, it is built on the next call then
+   */
+  bool LoadFreeSpaceMap();
+
+  /**
+   * Make sure the free space map has room for count more entries, adding map pages as needed. Called before the heap
+   * pages the entries are for are linked into the heap, so that no page of the heap is left without an entry.
+   * @return false if a map page could not be allocated
+   */
+  bool ReserveFreeSpaceEntries(size_t count);
+
+  /**
+   * Append the entry of a new last page of the heap to the free space map, room for it must have been reserved.
+   */
+  void AppendFreeSpaceEntry(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Record the room left on a page of the heap in the free space map.
+   */
+  void UpdateFreeSpace(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * @return the first page of the heap whose bucket in the free space map covers size bytes, INVALID_PAGE_ID if none
+   */
+  page_id_t FindFreePage(uint32_t size);
+
+  /**
+   * Append empty pages to the end of the heap. The heap grows by a run of contiguous pages as long as the heap itself,
+   * between DEFAULT_HEAP_GROW_MIN_PAGES and DEFAULT_HEAP_GROW_MAX_PAGES, so that scans read it sequentially.
+   * @param last_page_id the current last page of the heap
+   * @param page_count number of pages in the heap
+   * @return id of the first new page, INVALID_PAGE_ID if no page could be allocated
+   */
+  page_id_t GrowHeap(page_id_t last_page_id, size_t page_count, Transaction *txn);
+
   /**
    * create table heap and initialize first page
    */
@@ -115,16 +217,24 @@ private:
           lock_manager_(lock_manager) {
     auto Table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
     Table_page->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    uint32_t free_space = Table_page->GetFreeSpaceRemaining();
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    last_page_id_ = first_page_id_;
+    // without a page for the map now, the map is built from the page list on first use
+    if (ReserveFreeSpaceEntries(1)) {
+      fsm_loaded_ = true;
+      AppendFreeSpaceEntry(first_page_id_, free_space);
+    }
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, page_id_t fsm_page_id)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        fsm_page_id_(fsm_page_id) {}
 
  private:
   BufferPoolManager *buffer_pool_manager_;
@@ -132,6 +242,12 @@ private:
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  page_id_t fsm_page_id_{INVALID_PAGE_ID};
+  bool fsm_loaded_{false};
+  std::vector<page_id_t> fsm_page_ids_;                  // pages of the free space map in list order
+  std::vector<uint8_t> fsm_max_buckets_;                 // per map page, no entry on it has a larger bucket
+  std::unordered_map<page_id_t, uint32_t> fsm_entries_;  // heap page to the index of its entry in the map
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
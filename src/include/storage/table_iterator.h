@@ -1,16 +1,24 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
 #include "common/rowid.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "transaction/transaction.h"
 
 class TableHeap;
+class TablePage;
 
 class TableIterator {
 public:
   // you may define your own constructor based on your member variables
-  explicit TableIterator(TableHeap *TbHeap, RowId rowid);
+  /**
+   * @param strategy ring used to fetch the heap pages while iterating, nullptr to go through the shared pool
+   */
+  explicit TableIterator(TableHeap *TbHeap, RowId rowid, BufferAccessStrategy *strategy = nullptr);
 
   explicit TableIterator(const TableIterator &other);
 
@@ -31,9 +39,53 @@ public:
   TableIterator operator++(int);
 
 private:
+  /**
+   * Keep the read-ahead window of the buffer pool in flight ahead of the heap page the iterator is on.
+   */
+  void ReadAhead(TablePage *page);
+
   // add your own private member variables here
     TableHeap* table_heap; 
     Row* row; 
+    BufferAccessStrategy *strategy_{nullptr};
+    page_id_t read_ahead_page_id_{INVALID_PAGE_ID};  // last page ReadAhead was called on
+    size_t read_ahead_pages_{0};                     // pages already requested ahead of it
+};
+
+/**
+ * Batch iterator over a table heap, e.g. for a sequential scan. Each NextBatch pins a heap page once, decodes all of
+ * its live rows into a batch reused from page to page and unpins it, where TableIterator fetches the page twice and
+ * allocates a new row for every tuple.
+ */
+class TableBatchIterator {
+ public:
+  /**
+   * @param strategy ring used to fetch the heap pages, nullptr to go through the shared pool
+   * @param filter if set, only the rows it accepts are decoded into the batches
+   */
+  explicit TableBatchIterator(TableHeap *table_heap = nullptr, BufferAccessStrategy *strategy = nullptr,
+                              RowFilter filter = nullptr);
+
+  /**
+   * Read the rows of the next heap page that has any, or any the filter accepts, into the batch.
+   * @return false once the heap is exhausted, the batch is empty then
+   */
+  bool NextBatch();
+
+  /** @return the number of rows in the batch */
+  inline size_t GetBatchSize() const { return batch_size_; }
+
+  /** @return the i-th row of the batch, valid until the next call of NextBatch */
+  inline Row &GetRow(size_t i) { return batch_[i]; }
+
+ private:
+  TableHeap *table_heap_;
+  BufferAccessStrategy *strategy_;
+  RowFilter filter_;
+  page_id_t next_page_id_;        // next heap page to read, INVALID_PAGE_ID once the heap is exhausted
+  std::vector<Row> batch_;        // rows of the current page, followed by leftovers kept for reuse
+  size_t batch_size_{0};
+  size_t read_ahead_pages_{0};    // pages already requested ahead of the current page
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
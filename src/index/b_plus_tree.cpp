@@ -1,5 +1,6 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
 #include <exception>
 #include "glog/logging.h"
@@ -27,7 +28,7 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
     {
       internal_max_size_ = (int)((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (KM.GetKeySize() + sizeof(page_id_t)) - 1);
     }
-    auto root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID));
+    auto root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
 
     if (!root_page->GetRootId(index_id, &this->root_page_id_)) {
       this->root_page_id_ = INVALID_PAGE_ID;
@@ -88,6 +89,92 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transac
     }
     return InsertIntoLeaf(key, value, transaction);   // 否则插入叶子节点
 }
+bool BPlusTree::BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries) {
+  if (!IsEmpty()) {
+    return false;
+  }
+  if (entries.empty()) {
+    return true;
+  }
+  std::vector<std::pair<GenericKey *, page_id_t>> level;
+  std::vector<page_id_t> loaded_pages;
+  // the root is only set once every level is built, on failure give back the pages and leave the tree empty
+  auto abort_load = [&]() {
+    for (auto page_id : loaded_pages) {
+      if (!buffer_pool_manager_->IsPageFree(page_id)) {
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+    }
+    return false;
+  };
+  page_id_t prev_leaf_id = INVALID_PAGE_ID;
+  auto fill_leaf = [&](Page *page, size_t begin, size_t end) {
+    loaded_pages.push_back(page->GetPageId());
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page->GetPageId(), INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+    for (size_t i = begin; i < end; i++) {
+      leaf->SetKeyAt(static_cast<int>(i - begin), entries[i].first);
+      leaf->SetValueAt(static_cast<int>(i - begin), entries[i].second);
+    }
+    leaf->SetSize(static_cast<int>(end - begin));
+    if (prev_leaf_id != INVALID_PAGE_ID) {
+      auto prev_leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(prev_leaf_id)->GetData());
+      prev_leaf->SetNextPageId(page->GetPageId());
+      buffer_pool_manager_->UnpinPage(prev_leaf_id, true);
+    }
+    prev_leaf_id = page->GetPageId();
+    return entries[begin].first;
+  };
+  // leave room for one insert in every node, so that the first inserts after the load do not split right away
+  if (!BulkLoadLevel(entries.size(), leaf_max_size_ - 1, fill_leaf, &level)) {
+    return abort_load();
+  }
+  while (level.size() > 1) {
+    std::vector<std::pair<GenericKey *, page_id_t>> children = std::move(level);
+    auto fill_internal = [&](Page *page, size_t begin, size_t end) {
+      loaded_pages.push_back(page->GetPageId());
+      auto node = reinterpret_cast<InternalPage *>(page->GetData());
+      node->Init(page->GetPageId(), INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+      for (size_t i = begin; i < end; i++) {
+        node->SetKeyAt(static_cast<int>(i - begin), children[i].first);
+        node->SetValueAt(static_cast<int>(i - begin), children[i].second);
+        auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(children[i].second)->GetData());
+        child->SetParentPageId(page->GetPageId());
+        buffer_pool_manager_->UnpinPage(children[i].second, true);
+      }
+      node->SetSize(static_cast<int>(end - begin));
+      return children[begin].first;
+    };
+    if (!BulkLoadLevel(children.size(), internal_max_size_ - 1, fill_internal, &level)) {
+      return abort_load();
+    }
+  }
+  root_page_id_ = level.front().second;
+  UpdateRootPageId(1);
+  return true;
+}
+
+bool BPlusTree::BulkLoadLevel(size_t num_items, size_t max_items,
+                              const std::function<GenericKey *(Page *page, size_t begin, size_t end)> &fill,
+                              std::vector<std::pair<GenericKey *, page_id_t>> *nodes) {
+  size_t num_nodes = (num_items + max_items - 1) / max_items;
+  size_t begin = 0;
+  nodes->clear();
+  auto init = [&](Page *page) {
+    size_t end = begin + num_items / num_nodes + (nodes->size() < num_items % num_nodes ? 1 : 0);
+    nodes->emplace_back(fill(page, begin, end), page->GetPageId());
+    begin = end;
+  };
+  while (nodes->size() < num_nodes) {
+    size_t count = std::min<size_t>(num_nodes - nodes->size(), DEFAULT_INDEX_BULK_LOAD_PAGES);
+    if (buffer_pool_manager_->NewPages(count, init) == INVALID_PAGE_ID) {
+      LOG(WARNING) << "Failed to allocate pages for the bulk load of index " << index_id_;
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -474,7 +561,7 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
       LeafPage *leaf_node = reinterpret_cast<LeafPage *>(node);
       LeafPage *neighbor_leaf_node = reinterpret_cast<LeafPage *>(neighbor_node);
       Page* tmp_parent = buffer_pool_manager_->FetchPage(leaf_node->GetParentPageId());
-      InternalPage* parent = reinterpret_cast<InternalPage*>(tmp_parent);
+      InternalPage* parent = reinterpret_cast<InternalPage*>(tmp_parent->GetData());
 
       if (index == 0)
       {
@@ -495,7 +582,7 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
       InternalPage *internal_node = reinterpret_cast<InternalPage *>(node);
       InternalPage *neighbor_internal_node = reinterpret_cast<InternalPage *>(neighbor_node);
       Page* tmp_parent = buffer_pool_manager_->FetchPage(internal_node->GetParentPageId());
-      InternalPage* parent = reinterpret_cast<InternalPage*>(tmp_parent);
+      InternalPage* parent = reinterpret_cast<InternalPage*>(tmp_parent->GetData());
       if (index == 0)
       {
           neighbor_internal_node->MoveFirstToEndOf(internal_node,
@@ -504,14 +591,16 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
           for(int i=0; i<internal_node->GetSize(); i++)
           {
               Page* tmp_page = buffer_pool_manager_->FetchPage(internal_node->ValueAt(i));
-              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page);
+              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page->GetData());
               tmp_bpt_page->SetParentPageId(internal_node->GetPageId());
+              buffer_pool_manager_->UnpinPage(tmp_page->GetPageId(), true);
           }
           for(int i=0; i<neighbor_internal_node->GetSize(); i++)
           {
               Page* tmp_page = buffer_pool_manager_->FetchPage(neighbor_internal_node->ValueAt(i));
-              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page);
+              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page->GetData());
               tmp_bpt_page->SetParentPageId(neighbor_internal_node->GetPageId());
+              buffer_pool_manager_->UnpinPage(tmp_page->GetPageId(), true);
           }
       }
       else
@@ -522,14 +611,16 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
           for(int i=0; i<internal_node->GetSize(); i++)
           {
               Page* tmp_page = buffer_pool_manager_->FetchPage(internal_node->ValueAt(i));
-              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page);
+              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page->GetData());
               tmp_bpt_page->SetParentPageId(internal_node->GetPageId());
+              buffer_pool_manager_->UnpinPage(tmp_page->GetPageId(), true);
           }
           for(int i=0; i<neighbor_internal_node->GetSize(); i++)
           {
               Page* tmp_page = buffer_pool_manager_->FetchPage(neighbor_internal_node->ValueAt(i));
-              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page);
+              BPlusTreePage* tmp_bpt_page = reinterpret_cast<BPlusTreePage*>(tmp_page->GetData());
               tmp_bpt_page->SetParentPageId(neighbor_internal_node->GetPageId());
+              buffer_pool_manager_->UnpinPage(tmp_page->GetPageId(), true);
           }
       }
       buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
@@ -566,6 +657,106 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node)
     return old_root_node->IsLeafPage() && old_root_node->GetSize() == 0;
 }
 
+/*****************************************************************************
+ * RELOCATION
+ *****************************************************************************/
+void BPlusTree::GetPageIds(std::vector<page_id_t> *page_ids) {
+  if (IsEmpty()) {
+    return;
+  }
+  size_t begin = page_ids->size();
+  page_ids->push_back(root_page_id_);
+  // the pages appended so far are the queue of the breadth-first walk
+  for (size_t i = begin; i < page_ids->size(); i++) {
+    page_id_t page_id = (*page_ids)[i];
+    auto node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    if (!node->IsLeafPage()) {
+      auto internal = reinterpret_cast<InternalPage *>(node);
+      for (int j = 0; j < internal->GetSize(); j++) {
+        page_ids->push_back(internal->ValueAt(j));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+}
+
+void BPlusTree::RelocatePage(page_id_t old_page_id, page_id_t new_page_id) {
+  Page *old_page = buffer_pool_manager_->FetchPage(old_page_id);
+  Page *new_page = buffer_pool_manager_->FetchPage(new_page_id);
+  memcpy(new_page->GetData(), old_page->GetData(), PAGE_SIZE);
+  buffer_pool_manager_->UnpinPage(old_page_id, false);
+  auto node = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
+  node->SetPageId(new_page_id);
+  page_id_t parent_page_id = node->GetParentPageId();
+  if (node->IsRootPage()) {
+    root_page_id_ = new_page_id;
+    UpdateRootPageId();
+  } else {
+    auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_page_id)->GetData());
+    parent->SetValueAt(parent->ValueIndex(old_page_id), new_page_id);
+    buffer_pool_manager_->UnpinPage(parent_page_id, true);
+  }
+  if (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(internal->ValueAt(i))->GetData());
+      child->SetParentPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(internal->ValueAt(i), true);
+    }
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  // the previous leaf is the last leaf of the nearest subtree to the left, found going up and then down the right edge
+  page_id_t child_page_id = new_page_id;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  while (parent_page_id != INVALID_PAGE_ID && prev_page_id == INVALID_PAGE_ID) {
+    auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_page_id)->GetData());
+    int index = parent->ValueIndex(child_page_id);
+    if (index > 0) {
+      prev_page_id = parent->ValueAt(index - 1);
+    }
+    child_page_id = parent_page_id;
+    parent_page_id = parent->GetParentPageId();
+    buffer_pool_manager_->UnpinPage(child_page_id, false);
+  }
+  while (prev_page_id != INVALID_PAGE_ID) {
+    auto prev = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(prev_page_id)->GetData());
+    if (prev->IsLeafPage()) {
+      reinterpret_cast<LeafPage *>(prev)->SetNextPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      break;
+    }
+    auto internal = reinterpret_cast<InternalPage *>(prev);
+    page_id_t last_child_page_id = internal->ValueAt(internal->GetSize() - 1);
+    buffer_pool_manager_->UnpinPage(prev_page_id, false);
+    prev_page_id = last_child_page_id;
+  }
+}
+
+void BPlusTree::RelocateRows(const std::unordered_map<page_id_t, page_id_t> &moved_pages) {
+  if (IsEmpty() || moved_pages.empty()) {
+    return;
+  }
+  Page *page = FindLeafPage(nullptr, root_page_id_, true);
+  while (page != nullptr) {
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    bool is_dirty = false;
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      RowId rid = leaf->ValueAt(i);
+      auto iter = moved_pages.find(rid.GetPageId());
+      if (iter != moved_pages.end()) {
+        leaf->SetValueAt(i, RowId(iter->second, rid.GetSlotNum()));
+        is_dirty = true;
+      }
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    // the last leaf has next page id 0 (or INVALID_PAGE_ID), see BPlusTree::End
+    page = next_page_id == 0 || next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -660,7 +851,8 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  */
 void BPlusTree::UpdateRootPageId(int insert_record) 
 {
-    auto tmp_index_root_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
+    auto tmp_index_root_page =
+        reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
 
     if (insert_record != 0) {
         tmp_index_root_page->Insert(index_id_, root_page_id_);
@@ -26,6 +26,35 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::BulkLoad(const std::vector<std::pair<Row, RowId>> &entries, Transaction *txn) {
+  size_t key_size = processor_.GetKeySize();
+  std::vector<char> key_buf(entries.size() * key_size);
+  std::vector<std::pair<GenericKey *, RowId>> sorted_entries;
+  sorted_entries.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto index_key = reinterpret_cast<GenericKey *>(key_buf.data() + i * key_size);
+    processor_.SerializeFromKey(index_key, entries[i].first, key_schema_);
+    sorted_entries.emplace_back(index_key, entries[i].second);
+  }
+  std::stable_sort(sorted_entries.begin(), sorted_entries.end(), [this](const auto &lhs, const auto &rhs) {
+    return processor_.CompareKeys(lhs.first, rhs.first) < 0;
+  });
+  // keys are unique, keep the first entry of a key as inserting them one by one would
+  auto last = std::unique(sorted_entries.begin(), sorted_entries.end(), [this](const auto &lhs, const auto &rhs) {
+    return processor_.CompareKeys(lhs.first, rhs.first) == 0;
+  });
+  sorted_entries.erase(last, sorted_entries.end());
+  if (container_.IsEmpty() && container_.BulkLoad(sorted_entries)) {
+    return DB_SUCCESS;
+  }
+  // into a tree with entries already, or after a bulk load that could not get its pages and left the tree empty:
+  // inserted in key order, consecutive entries go to the same leaf while it is still in the buffer pool
+  for (auto &entry : sorted_entries) {
+    container_.Insert(entry.first, entry.second, txn);
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
@@ -91,6 +120,16 @@ dberr_t BPlusTreeIndex::Destroy() {
   return DB_SUCCESS;
 }
 
+void BPlusTreeIndex::GetPageIds(std::vector<page_id_t> *page_ids) { container_.GetPageIds(page_ids); }
+
+void BPlusTreeIndex::RelocatePage(page_id_t old_page_id, page_id_t new_page_id) {
+  container_.RelocatePage(old_page_id, new_page_id);
+}
+
+void BPlusTreeIndex::RelocateRows(const std::unordered_map<page_id_t, page_id_t> &moved_pages) {
+  container_.RelocateRows(moved_pages);
+}
+
 IndexIterator BPlusTreeIndex::GetBeginIterator() {
   return container_.Begin();
 }
@@ -8,7 +8,7 @@ IndexIterator::IndexIterator() = default;
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) 
 {
-  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id));
+  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
 }
 
 
@@ -21,6 +21,7 @@ IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int inde
         page = Page;
         current_page_id = Page->GetPageId();
         data = std::make_pair(page->KeyAt(item_index), page->ValueAt(item_index));
+        ReadAhead();
     }else{
         //end
         item_index = 0;
@@ -66,13 +67,32 @@ IndexIterator &IndexIterator::operator++()
         } 
         else 
         {
-            page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id));
+            page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
             item_index = 0;
+            ReadAhead();
         }
     }
     return *this;
 }
 
+void IndexIterator::ReadAhead() {
+    if (current_page_id == read_ahead_page_id_) {
+        return;
+    }
+    read_ahead_page_id_ = current_page_id;
+    size_t window = buffer_pool_manager->GetReadAheadWindow();
+    if (read_ahead_pages_ > 0) {
+        read_ahead_pages_--;
+    }
+    // the last leaf has next page id 0 (or INVALID_PAGE_ID), see BPlusTree::End
+    page_id_t next_page_id = page->GetNextPageId();
+    if (window == 0 || read_ahead_pages_ > window / 2 || next_page_id == 0 || next_page_id == INVALID_PAGE_ID) {
+        return;
+    }
+    buffer_pool_manager->PrefetchChain(next_page_id, window, LEAF_PAGE_NEXT_PAGE_ID_OFFSET);
+    read_ahead_pages_ = window;
+}
+
 bool IndexIterator::operator==(const IndexIterator &itr) const {
     return current_page_id == itr.current_page_id && item_index == itr.item_index;
 }
@@ -9,27 +9,53 @@ template <size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset)  // 分配内存页
 {
     if (page_allocated_ < GetMaxSupportedSize()) {
+        if (next_free_page_ >= GetMaxSupportedSize() || !IsPageFree(next_free_page_)) {
+            next_free_page_ = FindFreePage(0);
+        }
         page_allocated_++;
         page_offset = next_free_page_;  // 首先把当前空闲页的位置赋給page_offset用于返回
         bytes[page_offset / 8] = bytes[page_offset / 8] | (0x01 << (7 - page_offset % 8));  // 添加的那一位置1
-        uint32_t index = 0;
-        while (!IsPageFree(index) && index < GetMaxSupportedSize())  // 从零开始，找到下一个位置为0的页
-        {
-          index++;
-        }
-        next_free_page_ = index;  // 更新下一个空闲页的位置
+        // next_free_page_ is the lowest free page, so the next one lies after page_offset
+        next_free_page_ = FindFreePage(page_offset + 1);  // 更新下一个空闲页的位置
         return true;
     }
     return false;  // 如果没有空间，就返回false
 }
 
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePages(uint32_t count, uint32_t &page_offset) {
+  if (count == 0 || page_allocated_ + count > GetMaxSupportedSize()) {
+    return false;
+  }
+  uint32_t start = ScanPages(0, true);
+  while (start + count <= GetMaxSupportedSize()) {
+    uint32_t end = ScanPages(start, false);
+    if (end - start >= count) {
+      for (uint32_t i = start; i < start + count; i++) {
+        bytes[i / 8] |= 0x80 >> (i % 8);
+      }
+      page_allocated_ += count;
+      if (start <= next_free_page_) {
+        next_free_page_ = FindFreePage(start + count);
+      }
+      page_offset = start;
+      return true;
+    }
+    if (end == GetMaxSupportedSize()) {
+      break;
+    }
+    start = ScanPages(end, true);
+  }
+  return false;
+}
+
 /**
  * TODO: Student Implement
  */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
     if (!IsPageFree(page_offset)) {
-        if (page_allocated_ == GetMaxSupportedSize()) {
+        if (page_allocated_ == GetMaxSupportedSize() || page_offset < next_free_page_) {
             next_free_page_ = page_offset;  // 如果所有页是满的，那么下一个空闲页就是当前页
         }
         // 将删掉的那一位置0
@@ -58,6 +84,45 @@ uint32_t BitmapPage<PageSize>::GetNextFreePage() const {
   return next_free_page_;
 };
 
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindFreePage(uint32_t start) const {
+  uint32_t page_offset = start < GetMaxSupportedSize() ? ScanPages(start, true) : GetMaxSupportedSize();
+  if (page_offset == GetMaxSupportedSize() && start > 0) {
+    page_offset = ScanPages(0, true);
+  }
+  return page_offset;
+}
+
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::ScanPages(uint32_t start, bool free) const {
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "the bitmap must consist of whole words");
+  constexpr uint32_t num_words = MAX_CHARS / sizeof(uint64_t);
+  constexpr uint64_t all_ones = ~uint64_t{0};
+  // look for a zero bit, in the inverted word when looking for an allocated page
+  uint64_t invert = free ? 0 : all_ones;
+  // the pages before start in its word do not match
+  uint64_t skip = start % 64 == 0 ? 0 : all_ones << (64 - start % 64);
+  for (uint32_t word_index = start / 64; word_index < num_words; word_index++) {
+    uint64_t word = (GetWord(word_index) ^ invert) | skip;
+    if (word != all_ones) {
+      return word_index * 64 + __builtin_clzll(~word);
+    }
+    skip = 0;
+  }
+  return GetMaxSupportedSize();
+}
+
+template <size_t PageSize>
+uint64_t BitmapPage<PageSize>::GetWord(uint32_t word_index) const {
+  uint64_t word;
+  memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // the first byte holds the lowest offsets
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
 template class BitmapPage<64>;
 
 template class BitmapPage<128>;
@@ -0,0 +1,18 @@
+#include "page/free_space_map_page.h"
+
+uint32_t FreeSpaceMapPage::FindBucket(uint8_t bucket) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (buckets_[i] >= bucket) {
+      return i;
+    }
+  }
+  return count_;
+}
+
+uint8_t FreeSpaceMapPage::GetMaxBucket() const {
+  uint8_t max_bucket = 0;
+  for (uint32_t i = 0; i < count_; i++) {
+    max_bucket = std::max(max_bucket, buckets_[i]);
+  }
+  return max_bucket;
+}
@@ -164,6 +164,32 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+size_t TablePage::GetTuples(std::vector<Row> *rows, Schema *schema, const RowFilter &filter) {
+  size_t count = 0;
+  RowView view;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (IsDeleted(tuple_size)) {
+      continue;
+    }
+    if (filter != nullptr) {
+      view.Reset(GetData() + GetTupleOffsetAtSlot(i), schema, RowId(GetTablePageId(), i));
+      if (!filter(view)) {
+        continue;
+      }
+    }
+    if (count == rows->size()) {
+      rows->emplace_back();
+    }
+    Row &row = (*rows)[count++];
+    row.destroy();
+    row.SetRowId(RowId(GetTablePageId(), i));
+    uint32_t __attribute__((unused)) read_bytes = row.DeserializeFrom(GetData() + GetTupleOffsetAtSlot(i), schema);
+    ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  }
+  return count;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
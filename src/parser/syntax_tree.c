@@ -169,6 +169,14 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeShowBufferStatus:
+      return "kNodeShowBufferStatus";
+    case kNodeSetVariable:
+      return "kNodeSetVariable";
+    case kNodeCheckpoint:
+      return "kNodeCheckpoint";
+    case kNodeVacuum:
+      return "kNodeVacuum";
     default:
       return "error type";
   }
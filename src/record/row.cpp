@@ -4,49 +4,41 @@
  * TODO: Student Implement
  */
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-    if (fields_.size() == 0)  // 如果是空行，直接返回0
-    {
-        return 0;
+  if (fields_.empty()) {
+    return 0;
+  }
+  ASSERT(fields_.size() == schema->GetColumnCount(), "Fields do not match the schema.");
+  uint32_t field_num = fields_.size();
+  MACH_WRITE_UINT32(buf, FORMAT_VERSION << 24 | field_num);
+  char *null_bitmap = buf + sizeof(uint32_t);
+  memset(null_bitmap, 0, (field_num + 7) / 8);
+  uint32_t char_end = schema->GetRowFixedSize();
+  for (uint32_t i = 0; i < field_num; i++) {
+    Field *field = fields_[i];
+    char *slot = buf + schema->GetFieldOffset(i);
+    if (!field->IsNull()) {
+      null_bitmap[i / 8] |= static_cast<char>(0x80 >> (i % 8));
     }
-    uint32_t Offset = 0;
-    uint32_t fields_num = fields_.size();
-    MACH_WRITE_UINT32(buf, fields_num);  // 写入fields的数量
-    Offset += 4;
-    buf += 4;
-    uint32_t size = (uint32_t)ceil((double)fields_.size() / 8) * 8;  // 向上取整到8的倍数
-    uint32_t map_cnt = 0;                                            // map_cnt代表bitmap中的第几个元素
-    uint32_t map[size];
-    while (map_cnt < size / 8)  // 每次循环写入一个bitmap
-    {
-        char bitmap = 0;
-        for (uint32_t i = 0; i < 8; i++)  // 每次循环写入一个bitmap中的一个bit
-        {
-          if ((map_cnt * 8 + i < fields_.size()) && (fields_.at(map_cnt * 8 + i)->IsNull() == false))  // 如果不为空，写入1
-          {
-              bitmap = bitmap | (0x01 << (7 - i));
-              map[map_cnt * 8 + i] = 1;  // map中对应的位置也写入1
-          }
-          else
-              map[map_cnt * 8 + i] = 0;  // 如果为空，写入0
-        }
-        map_cnt++;                         // map_cnt向后推进一位
-        MACH_WRITE_TO(char, buf, bitmap);  // 写入bitmap
-        Offset++;
-        buf++;
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      if (!field->IsNull()) {
+        memcpy(buf + char_end, field->GetData(), field->GetLength());
+        char_end += field->GetLength();
+      }
+      MACH_WRITE_UINT32(slot, char_end);
+    } else if (field->IsNull()) {
+      memset(slot, 0, Type::GetTypeSize(schema->GetColumn(i)->GetType()));
+    } else {
+      field->SerializeTo(slot);
     }
-    for (uint32_t i = 0; i < fields_.size(); i++)  // 写入fields
-    {
-        if (map[i])  // 如果不为空
-        {
-          uint32_t temp = fields_.at(i)->SerializeTo(buf);  // 写入fields
-          buf += temp;
-          Offset += temp;
-        }
-    }
-    return Offset;
+  }
+  return char_end;
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
+    if (MACH_READ_UINT32(buf) >> 24 == FORMAT_VERSION)  // 新格式，按Schema中的偏移读取
+    {
+        return DeserializeFixedOffset(buf, schema);
+    }
     uint32_t Offset = 0;
     uint32_t field_num = 0;
     field_num = MACH_READ_UINT32(buf);  // 读取fields的数量
@@ -108,18 +100,38 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
     return Offset;
 }
 
-uint32_t Row::GetSerializedSize(Schema *schema) const {
-    if (fields_.size() == 0) {// 如果是空行，直接返回0
-        return 0;
+uint32_t Row::DeserializeFixedOffset(char *buf, Schema *schema) {
+  uint32_t field_num = MACH_READ_UINT32(buf) & FIELD_NUM_MASK;
+  const char *null_bitmap = buf + sizeof(uint32_t);
+  uint32_t char_end = schema->GetRowFixedSize();
+  for (uint32_t i = 0; i < field_num; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    char *slot = buf + schema->GetFieldOffset(i);
+    bool is_null = (null_bitmap[i / 8] & (0x80 >> (i % 8))) == 0;
+    Field *field = nullptr;
+    if (type == TypeId::kTypeChar) {
+      uint32_t char_begin = char_end;
+      char_end = MACH_READ_UINT32(slot);
+      field = is_null ? new Field(type) : new Field(type, buf + char_begin, char_end - char_begin, true);
+    } else {
+      Field::DeserializeFrom(slot, type, &field, is_null);
     }
-    uint32_t Offset = 4 + (uint32_t)ceil((double)fields_.size() / 8); // 代表的是fields的数量的大小+bitmap的大小
-    // fields
-    for (uint32_t i = 0; i < fields_.size(); i++) { // 遍历fields
-        if (!fields_.at(i)->IsNull()) {
-            Offset += fields_.at(i)->GetSerializedSize(); // 如果不为空，Offset向后推进fields的大小
-        }
+    fields_.push_back(field);
+  }
+  return char_end;
+}
+
+uint32_t Row::GetSerializedSize(Schema *schema) const {
+  if (fields_.empty()) {
+    return 0;
+  }
+  uint32_t size = schema->GetRowFixedSize();
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar && !fields_[i]->IsNull()) {
+      size += fields_[i]->GetLength();
     }
-    return Offset;
+  }
+  return size;
 }
 
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
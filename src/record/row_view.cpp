@@ -0,0 +1,63 @@
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, Schema *schema, RowId rid) {
+  data_ = data;
+  schema_ = schema;
+  rid_ = rid;
+  uint32_t header = MACH_READ_UINT32(data);
+  field_num_ = header & Row::FIELD_NUM_MASK;
+  fixed_offset_ = header >> 24 == Row::FORMAT_VERSION;
+  null_bitmap_ = data + sizeof(uint32_t);
+  if (fixed_offset_) {
+    return;
+  }
+  uint32_t offset = sizeof(uint32_t) + (field_num_ + 7) / 8;
+  offsets_.resize(field_num_);
+  for (uint32_t i = 0; i < field_num_; i++) {
+    offsets_[i] = offset;
+    if (IsNull(i)) {
+      continue;
+    }
+    switch (schema->GetColumn(i)->GetType()) {
+      case TypeId::kTypeChar:
+        offset += sizeof(uint32_t) + MACH_READ_UINT32(data + offset);
+        break;
+      default:
+        offset += Type::GetTypeSize(schema->GetColumn(i)->GetType());
+        break;
+    }
+  }
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  if (fixed_offset_ && type == TypeId::kTypeChar) {
+    uint32_t slot = schema_->GetFieldOffset(idx);
+    // the data of a CHAR field starts where the one of the previous CHAR field ends
+    uint32_t begin = slot == schema_->GetCharOffsetTableOffset() ? schema_->GetRowFixedSize()
+                                                                 : MACH_READ_UINT32(data_ + slot - sizeof(uint32_t));
+    uint32_t end = MACH_READ_UINT32(data_ + slot);
+    return Field(type, const_cast<char *>(data_) + begin, end - begin, false);
+  }
+  const char *value = data_ + (fixed_offset_ ? schema_->GetFieldOffset(idx) : offsets_[idx]);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float, value));
+    case TypeId::kTypeChar:
+      return Field(type, const_cast<char *>(value) + sizeof(uint32_t), MACH_READ_UINT32(value), false);
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return Field(type);
+  }
+}
+
+void RowView::Materialize(Row *row) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  row->DeserializeFrom(const_cast<char *>(data_), schema_);
+}
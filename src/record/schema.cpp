@@ -51,4 +51,24 @@ uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema) {
     }
     schema =  new Schema(ColumnArray);
     return Offset;
-}
\ No newline at end of file
+}
+
+void Schema::ComputeRowLayout() {
+  // header word and null bitmap, then the fixed-width values, then one end offset per CHAR column
+  uint32_t offset = sizeof(uint32_t) + (columns_.size() + 7) / 8;
+  field_offsets_.resize(columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() != TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += Type::GetTypeSize(columns_[i]->GetType());
+    }
+  }
+  char_table_offset_ = offset;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += sizeof(uint32_t);
+    }
+  }
+  row_fixed_size_ = offset;
+}
@@ -1,13 +1,31 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <filesystem>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
+
+/** O_DIRECT transfers need buffers aligned to the logical block size of the device, which PAGE_SIZE is a multiple of. */
+static bool IsAligned(const char *data) { return reinterpret_cast<uintptr_t>(data) % PAGE_SIZE == 0; }
+
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackend backend, DurabilityMode durability_mode,
+                         size_t segment_pages)
+    : segment_pages_(segment_pages == 0 ? 0 : std::max(segment_pages, BITMAP_SIZE)),
+      backend_(backend),
+      file_name_(db_file),
+      durability_mode_(DurabilityMode::OS_BUFFERED) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
@@ -24,90 +42,421 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw std::exception();
     }
   }
+  // a database with several segments keeps its segment size, which is the size of its first file
+  size_t file_size = std::max(GetFileSize(file_name_), static_cast<int64_t>(0));
+  if (std::filesystem::exists(GetSegmentFileName(file_name_, 1))) {
+    segment_pages_ = file_size / PAGE_SIZE;
+    if (backend_ == DiskIOBackend::FSTREAM) {
+      LOG(WARNING) << db_file << " has several segment files, falling back to positional I/O";
+      backend_ = DiskIOBackend::POSITIONAL;
+    }
+  } else if (backend_ == DiskIOBackend::FSTREAM || file_size > segment_pages_ * PAGE_SIZE) {
+    // e.g. a database created before segment files
+    segment_pages_ = 0;
+  }
+  if (segment_pages_ != 0) {
+    max_segments_ = MapPageId(MAX_VALID_PAGE_ID - 1) / segment_pages_ + 1;
+  }
+  segments_ = std::make_unique<std::atomic<Segment *>[]>(max_segments_);
+  if (OpenSegment(0, true) == nullptr) {
+    throw std::exception();
+  }
+  for (size_t index = 1; index < max_segments_ && OpenSegment(index, false) != nullptr; index++) {
+  }
+  if (backend_ != DiskIOBackend::FSTREAM) {
+    // the stream was only needed to create the file
+    db_io_.close();
+  }
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  SetDurabilityMode(durability_mode);
 }
 
 void DiskManager::Close() {
+  {
+    // the engine waits for the I/O in flight
+    std::scoped_lock<std::mutex> lock(io_engine_latch_);
+    io_engine_.reset();
+  }
+  StopSyncer();
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
-    db_io_.close();
+    Sync();
+    for (size_t index = 0; index < max_segments_; index++) {
+      Segment *segment = segments_[index].exchange(nullptr);
+      if (segment == nullptr) {
+        continue;
+      }
+      if (segment->mapping_ != nullptr) {
+        munmap(segment->mapping_, segment->file_size_);
+      }
+      close(segment->fd_);
+      delete segment;
+    }
+    if (db_io_.is_open()) {
+      db_io_.close();
+    }
     closed = true;
   }
 }
 
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+  auto lock = LockPageIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+const char *DiskManager::GetPagePointer(page_id_t logical_page_id) {
+  ASSERT(backend_ == DiskIOBackend::MMAP, "Page pointers need a mapped database file.");
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  size_t offset;
+  Segment *segment = LocateSegment(MapPageId(logical_page_id), &offset);
+  return segment != nullptr && offset + PAGE_SIZE <= segment->file_size_ ? segment->mapping_ + offset : EMPTY_PAGE_DATA;
+}
+
+void DiskManager::ReadPages(page_id_t first_logical_page_id, size_t count, char *page_data) {
+  auto lock = LockPageIO();
+  ASSERT(first_logical_page_id >= 0, "Invalid page id.");
+  while (count > 0) {
+    // the pages of one extent are contiguous in the file, the next extent starts after its bitmap page
+    size_t run = std::min(count, BITMAP_SIZE - first_logical_page_id % BITMAP_SIZE);
+    ReadPhysicalPages(MapPageId(first_logical_page_id), run, page_data);
+    first_logical_page_id += static_cast<page_id_t>(run);
+    page_data += run * PAGE_SIZE;
+    count -= run;
+  }
+}
+
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+  auto lock = LockPageIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+void DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  if (pages.empty()) {
+    return;
+  }
+  std::sort(pages.begin(), pages.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  auto lock = LockPageIO();
+  if (!IsPositional() || closed) {
+    for (auto &[page_id, page_data] : pages) {
+      ASSERT(page_id >= 0, "Invalid page id.");
+      WritePhysicalPage(MapPageId(page_id), page_data);
+    }
+    return;
+  }
+  ASSERT(pages.front().first >= 0, "Invalid page id.");
+  std::vector<IORequest> io_requests;
+  std::vector<std::unique_ptr<char, decltype(&free)>> bounces;
+  IOBatch batch;
+  size_t begin = 0;
+  while (begin < pages.size()) {
+    // logical pages are adjacent in the file unless a bitmap page lies between them, a run ends with its segment
+    physical_page_id_t first_physical_page_id = MapPageId(pages[begin].first);
+    size_t max_run = PagesInSegment(first_physical_page_id, IOV_MAX);
+    size_t end = begin + 1;
+    while (end < pages.size() && end - begin < max_run &&
+           MapPageId(pages[end].first) == first_physical_page_id + static_cast<physical_page_id_t>(end - begin)) {
+      end++;
+    }
+    Segment *segment = GrowFile(first_physical_page_id + static_cast<physical_page_id_t>(end - begin) - 1);
+    if (segment == nullptr) {
+      begin = end;
+      continue;
+    }
+    IORequest &io_request = io_requests.emplace_back();
+    io_request.fd_ = segment->fd_;
+    io_request.write_ = true;
+    LocateSegment(first_physical_page_id, &io_request.offset_);
+    io_request.size_ = (end - begin) * PAGE_SIZE;
+    for (; begin < end; begin++) {
+      const char *page_data = pages[begin].second;
+      if (backend_ == DiskIOBackend::DIRECT && !IsAligned(page_data)) {
+        auto &bounce = bounces.emplace_back(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)), &free);
+        memcpy(bounce.get(), page_data, PAGE_SIZE);
+        page_data = bounce.get();
+      }
+      io_request.iov_.push_back({const_cast<char *>(page_data), PAGE_SIZE});
+    }
+    io_request.callback_ = [segment, &batch](bool) {
+      segment->unsynced_ = true;
+      batch.Done();
+    };
+  }
+  batch.Add(io_requests.size());
+  {
+    std::scoped_lock<std::mutex> engine_lock(io_engine_latch_);
+    SubmitIORequests(std::move(io_requests));
+  }
+  // only the runs of this batch are waited for, not the other I/O in flight
+  batch.Wait();
+  AfterWrite(pages.size());
+}
+
+void DiskManager::SubmitPageIO(std::vector<PageIORequest> requests) {
+  std::scoped_lock<std::mutex> lock(io_engine_latch_);
+  if (!IsPositional() || closed) {
+    for (auto &request : requests) {
+      if (request.write_) {
+        WritePage(request.page_id_, request.data_);
+      } else {
+        ReadPage(request.page_id_, request.data_);
+      }
+      if (request.callback_) {
+        request.callback_();
+      }
+    }
+    return;
+  }
+  std::vector<IORequest> io_requests;
+  io_requests.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    ASSERT(requests[i].page_id_ >= 0, "Invalid page id.");
+    if (backend_ == DiskIOBackend::DIRECT && !IsAligned(requests[i].data_)) {
+      // the engine hands the buffer to the kernel as is, so an unaligned one is carried out here
+      if (requests[i].write_) {
+        WritePage(requests[i].page_id_, requests[i].data_);
+      } else {
+        ReadPage(requests[i].page_id_, requests[i].data_);
+      }
+      if (requests[i].callback_) {
+        requests[i].callback_();
+      }
+      continue;
+    }
+    physical_page_id_t physical_page_id = MapPageId(requests[i].page_id_);
+    size_t offset;
+    Segment *segment = requests[i].write_ ? GrowFile(physical_page_id, &offset)
+                                          : LocateSegment(physical_page_id, &offset);
+    if (segment == nullptr) {
+      // a page of a segment that does not exist yet reads as zeros, a write to it failed to create the segment
+      if (!requests[i].write_) {
+        memset(requests[i].data_, 0, PAGE_SIZE);
+      }
+      if (requests[i].callback_) {
+        requests[i].callback_();
+      }
+      continue;
+    }
+    IORequest &io_request = io_requests.emplace_back();
+    io_request.fd_ = segment->fd_;
+    io_request.write_ = requests[i].write_;
+    io_request.offset_ = offset;
+    io_request.data_ = requests[i].data_;
+    io_request.size_ = PAGE_SIZE;
+    io_request.callback_ = [this, segment, write = io_request.write_, callback = std::move(requests[i].callback_)](
+                               bool) {
+      if (write) {
+        segment->unsynced_ = true;
+        AfterWrite();
+      }
+      if (callback) {
+        callback();
+      }
+    };
+  }
+  SubmitIORequests(std::move(io_requests));
+}
+
+void DiskManager::SubmitIORequests(std::vector<IORequest> requests) {
+  if (io_engine_ == nullptr) {
+    io_engine_ = IOEngine::Create(segments_[0].load()->fd_, IOEngineType::IO_URING);
+  }
+  io_engine_->Submit(std::move(requests));
+}
+
+void DiskManager::WaitForPageIO() {
+  std::scoped_lock<std::mutex> lock(io_engine_latch_);
+  if (io_engine_ != nullptr) {
+    io_engine_->Drain();
+  }
+}
+
+void DiskManager::SetIOEngine(IOEngineType type, size_t queue_depth) {
+  std::scoped_lock<std::mutex> lock(io_engine_latch_);
+  if (!IsPositional() || closed) {
+    return;
+  }
+  io_engine_.reset();
+  io_engine_ = IOEngine::Create(segments_[0].load()->fd_, type, queue_depth);
+}
+
+IOEngine *DiskManager::GetIOEngine() {
+  std::scoped_lock<std::mutex> lock(io_engine_latch_);
+  if (io_engine_ == nullptr && IsPositional() && !closed) {
+    io_engine_ = IOEngine::Create(segments_[0].load()->fd_, IOEngineType::IO_URING);
+  }
+  return io_engine_.get();
+}
+
 /**
  * TODO: Student Implement
  */
 page_id_t DiskManager::AllocatePage() 
 {
-    uint32_t meta_data_uint[PAGE_SIZE/4]; 
-    memcpy(meta_data_uint, meta_data_, 4096);   //读取meta_data到一个新的数组中用于修改
+    if (backend_ == DiskIOBackend::MMAP)    //只读映射的数据库不能分配新页
+    {
+        LOG(ERROR) << "Cannot allocate a page in a read-only database";
+        return INVALID_PAGE_ID;
+    }
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
 
-    size_t page_id;
     // 寻找第一个没有满额的extent
-    uint32_t extent_id = 0;
-
-    //meta_data_uint[2]开始存储每个extent已经分配的page数量，meta_data_uint[0]代表page的总数，meta_data_uint[1]代表extent的总数
-    while (*(meta_data_uint+2+extent_id) == BITMAP_SIZE) //如果分配的page的数量等于BITMAP_SIZE(Bitmap的size即为该分区page的总数)，说明这个extent已经满了，需要寻找下一个extent
+    uint32_t extent_id = first_free_extent_;
+    const uint32_t max_extents = MAX_VALID_PAGE_ID / BITMAP_SIZE;
+    //extent_used_page_存储每个extent已经分配的page数量，如果分配的page的数量等于BITMAP_SIZE，说明这个extent已经满了，需要寻找下一个extent
+    while (extent_id < max_extents && *GetExtentUsedPages(extent_id) == BITMAP_SIZE)
     {
         extent_id++;
     };
+    first_free_extent_ = extent_id;
+    if (extent_id == max_extents)
+    {
+        LOG(ERROR) << "The database file is full";
+        return INVALID_PAGE_ID;
+    }
 
-    // 读取对应extent的bitmap_page，寻找第一个free的page
-    char Bitmap[PAGE_SIZE];
-    page_id_t BitmapPhysicalID = 1 + extent_id * (BITMAP_SIZE + 1);   //计算Bitmap的物理页号
-    ReadPhysicalPage(BitmapPhysicalID, Bitmap);   //读取bitmap_page
-
-    BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(Bitmap); //将char*转换为BitmapPage*，方便操作（使用已实现的类BitmapPage）
-    uint32_t next_free_page = bitmap_page->GetNextFreePage();
-    page_id = extent_id * BITMAP_SIZE + next_free_page;   //计算逻辑页号
-
+    // 在缓存的bitmap中寻找第一个free的page
+    BitmapPage<PAGE_SIZE> *bitmap_page = GetExtentBitmap(extent_id);
+    uint32_t next_free_page;
     bitmap_page->AllocatePage(next_free_page);
+    page_id_t page_id = extent_id * BITMAP_SIZE + next_free_page;   //计算逻辑页号
+
     // 修改meta_data
-    if (extent_id >= *(meta_data_uint+1))
-        ++ *(meta_data_uint+1);
-    ++ *(meta_data_uint+2+extent_id);
-    ++ *(meta_data_uint);
-
-    memcpy(meta_data_,meta_data_uint, 4096);
-    WritePhysicalPage(META_PAGE_ID, meta_data_);    //将修改后的meta_data写回磁盘
-    WritePhysicalPage(BitmapPhysicalID, Bitmap);    //将修改后的bitmap_page写回磁盘
+    if (extent_id >= meta_page->num_extents_)
+        ++meta_page->num_extents_;
+    ++*GetExtentUsedPages(extent_id);
+    ++meta_page->num_allocated_pages_;
+
+    WriteMetaPage();                //将修改后的meta_data写回磁盘
+    WriteExtentUsedPages(extent_id);
+    WriteExtentBitmap(extent_id);   //将修改后的bitmap_page写回磁盘
     return page_id; //返回逻辑页号
 }
 
+page_id_t DiskManager::AllocatePages(size_t count) {
+  if (count == 0 || count > BITMAP_SIZE || backend_ == DiskIOBackend::MMAP) {
+    return INVALID_PAGE_ID;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  const uint32_t max_extents = MAX_VALID_PAGE_ID / BITMAP_SIZE;
+  for (uint32_t extent_id = first_free_extent_; extent_id < max_extents; extent_id++) {
+    uint32_t page_offset;
+    if (BITMAP_SIZE - *GetExtentUsedPages(extent_id) < count ||
+        !GetExtentBitmap(extent_id)->AllocatePages(count, page_offset)) {
+      continue;
+    }
+    if (extent_id >= meta_page->num_extents_) {
+      ++meta_page->num_extents_;
+    }
+    *GetExtentUsedPages(extent_id) += count;
+    meta_page->num_allocated_pages_ += count;
+    WriteMetaPage();
+    WriteExtentUsedPages(extent_id);
+    WriteExtentBitmap(extent_id);
+    return extent_id * BITMAP_SIZE + page_offset;
+  }
+  return INVALID_PAGE_ID;
+}
+
 /**
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) 
 {
-    char bitmap[PAGE_SIZE];
-    size_t pages_per_extent = 1 + BITMAP_SIZE;
-    page_id_t bitmap_physical_id = 1 + (logical_page_id / BITMAP_SIZE) * pages_per_extent;  //计算bitmap_page的物理页号
-    ReadPhysicalPage(bitmap_physical_id, bitmap);   //读取bitmap_page
-    auto *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap); //将char*转换为BitmapPage*，方便操作（使用已实现的类BitmapPage）
-
-    bitmap_page->DeAllocatePage(logical_page_id % BITMAP_SIZE);     //利用已实现的类BitmapPage中的DeAllocatePage()函数释放page
+    if (backend_ == DiskIOBackend::MMAP)
+    {
+        LOG(ERROR) << "Cannot free a page in a read-only database";
+        return;
+    }
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+    BitmapPage<PAGE_SIZE> *bitmap_page = GetExtentBitmap(extent_id);
+    if (!bitmap_page->DeAllocatePage(logical_page_id % BITMAP_SIZE)) {     //利用已实现的类BitmapPage中的DeAllocatePage()函数释放page
+        return;
+    }
 
-    uint32_t meta_data_uint[PAGE_SIZE/4];
-    memcpy(meta_data_uint, meta_data_, 4096);   //读取meta_data到一个新的数组中用于修改
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
     //   修改meta_data
-    uint32_t extent_id = logical_page_id / BITMAP_SIZE;
-    if (-- *(meta_data_uint + 2 + extent_id) == 0) -- *( meta_data_uint + 1 );  //如果该extent的page数量为0，说明该extent已经空了，需要减少extent的数量
-    -- *(meta_data_uint);   //总的page数量减少1
+    if (--*GetExtentUsedPages(extent_id) == 0) --meta_page->num_extents_;  //如果该extent的page数量为0，说明该extent已经空了，需要减少extent的数量
+    --meta_page->num_allocated_pages_;   //总的page数量减少1
+    first_free_extent_ = std::min(first_free_extent_, extent_id);
+
+    WriteMetaPage();                //将修改后的meta_data写回磁盘
+    WriteExtentUsedPages(extent_id);
+    WriteExtentBitmap(extent_id);   //将修改后的bitmap_page写回磁盘
+
+    // 位图落盘后再把该页占用的空间还给文件系统
+    pending_holes_.push_back(logical_page_id);
+    if (durability_mode_ == DurabilityMode::SYNC_EVERY_WRITE)
+        PunchHoles();
+}
+
+page_id_t DiskManager::GetLastAllocatedPageId() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  // the extent where the count of allocated pages is used up holds the last one
+  uint32_t remaining = meta_page->GetAllocatedPages();
+  if (remaining == 0) {
+    return INVALID_PAGE_ID;
+  }
+  const uint32_t max_extents = MAX_VALID_PAGE_ID / BITMAP_SIZE;
+  uint32_t extent_id = 0;
+  for (; extent_id + 1 < max_extents; extent_id++) {
+    uint32_t used_pages = *GetExtentUsedPages(extent_id);
+    if (used_pages >= remaining) {
+      break;
+    }
+    remaining -= used_pages;
+  }
+  BitmapPage<PAGE_SIZE> *bitmap_page = GetExtentBitmap(extent_id);
+  uint32_t page_offset = BITMAP_SIZE - 1;
+  while (page_offset > 0 && bitmap_page->IsPageFree(page_offset)) {
+    page_offset--;
+  }
+  return static_cast<page_id_t>(extent_id * BITMAP_SIZE + page_offset);
+}
 
-    memcpy(meta_data_,meta_data_uint, 4096);
-    WritePhysicalPage(META_PAGE_ID, meta_data_);    //将修改后的meta_data写回磁盘
-    WritePhysicalPage(bitmap_physical_id, bitmap);  //将修改后的bitmap_page写回磁盘
+size_t DiskManager::TruncateFile() {
+  if (backend_ == DiskIOBackend::MMAP) {
+    return 0;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  Sync();
+  page_id_t last_page_id = GetLastAllocatedPageId();
+  // the meta page and the bitmap page of the first extent are always kept
+  physical_page_id_t end = last_page_id == INVALID_PAGE_ID ? BitmapPhysicalPageId(0) + 1 : MapPageId(last_page_id) + 1;
+  size_t released = 0;
+  for (size_t index = 0; index < max_segments_; index++) {
+    Segment *segment = segments_[index];
+    if (segment == nullptr) {
+      break;
+    }
+    physical_page_id_t first = static_cast<physical_page_id_t>(index * segment_pages_);
+    size_t keep_size = end > first ? static_cast<size_t>(end - first) * PAGE_SIZE : 0;
+    size_t file_size = segment->file_size_;
+    if (keep_size >= file_size) {
+      continue;
+    }
+    released += file_size - keep_size;
+    if (keep_size == 0) {
+      segments_[index] = nullptr;
+      close(segment->fd_);
+      delete segment;
+      remove(GetSegmentFileName(file_name_, index).c_str());
+      continue;
+    }
+    std::scoped_lock<std::mutex> grow_lock(segment->grow_latch_);
+    if (ftruncate(segment->fd_, keep_size) != 0) {
+      LOG(ERROR) << "Failed to truncate the database file";
+      continue;
+    }
+    segment->file_size_ = keep_size;
+  }
+  return released;
 }
 
 /**
@@ -115,57 +464,251 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id)
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) 
 {
-    char bitmap[PAGE_SIZE];
-    size_t pages_per_extent = 1 + BITMAP_SIZE;
-    page_id_t bitmap_physical_id = 1 + (logical_page_id / BITMAP_SIZE) * pages_per_extent;  //计算bitmap_page的物理页号
-    ReadPhysicalPage(bitmap_physical_id, bitmap);   //读取bitmap_page
-
-    BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap); //将char*转换为BitmapPage*，方便操作（使用已实现的类BitmapPage）
-
-    if (bitmap_page->IsPageFree(logical_page_id % BITMAP_SIZE)) return true;    //利用已实现的类BitmapPage中的IsPageFree()函数判断page是否空闲
-    return false;   //如果不空闲，返回false
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    //利用已实现的类BitmapPage中的IsPageFree()函数判断page是否空闲
+    return GetExtentBitmap(logical_page_id / BITMAP_SIZE)->IsPageFree(logical_page_id % BITMAP_SIZE);
 }
 
 /**
  * TODO: Student Implement
  */
-page_id_t DiskManager::MapPageId(page_id_t logical_page_id)
+physical_page_id_t DiskManager::MapPageId(page_id_t logical_page_id)
 {
-    page_id_t extent_num = logical_page_id / BITMAP_SIZE + 1; // 相当于要加上的位图页的个数
-    return logical_page_id + 1 + extent_num;    //位图页个数加上逻辑页数加1即为物理页数
+    // 页紧跟在所属extent的位图页之后，位图页的位置已经算上了之前的位图页和目录页
+    return BitmapPhysicalPageId(logical_page_id / BITMAP_SIZE) + 1 + logical_page_id % BITMAP_SIZE;
+}
+
+std::unique_lock<std::recursive_mutex> DiskManager::LockPageIO() {
+  if (backend_ == DiskIOBackend::FSTREAM) {
+    return std::unique_lock<std::recursive_mutex>(db_io_latch_);
+  }
+  return std::unique_lock<std::recursive_mutex>(db_io_latch_, std::defer_lock);
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
-#ifdef ENABLE_BPM_DEBUG
-    LOG(INFO) << "Read less than a page" << std::endl;
-#endif
-    memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-#ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
-#endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+std::string DiskManager::GetSegmentFileName(const std::string &db_file, size_t index) {
+  if (index == 0) {
+    return db_file;
+  }
+  // a hidden file next to the database file, so that it is never taken for a database itself
+  auto pos = db_file.find_last_of('/') + 1;
+  return db_file.substr(0, pos) + "." + db_file.substr(pos) + "." + std::to_string(index);
+}
+
+void DiskManager::RemoveDatabaseFiles(const std::string &db_file) {
+  remove(db_file.c_str());
+  for (size_t index = 1; remove(GetSegmentFileName(db_file, index).c_str()) == 0; index++) {
+  }
+}
+
+DiskManager::Segment *DiskManager::OpenSegment(size_t index, bool create) {
+  std::string file_name = GetSegmentFileName(file_name_, index);
+  int flags = backend_ == DiskIOBackend::MMAP     ? O_RDONLY
+              : backend_ == DiskIOBackend::DIRECT ? O_RDWR | O_DIRECT
+                                                  : O_RDWR;
+  if (create && backend_ != DiskIOBackend::MMAP) {
+    flags |= O_CREAT;
+  }
+  int fd = open(file_name.c_str(), flags, 0644);
+  if (fd < 0 && backend_ == DiskIOBackend::DIRECT && errno == EINVAL) {
+    // e.g. tmpfs, a later segment may also be a link to such a file system
+    LOG(WARNING) << "O_DIRECT is not supported for " << file_name << ", falling back to buffered I/O";
+    if (index == 0) {
+      backend_ = DiskIOBackend::POSITIONAL;
     }
+    fd = open(file_name.c_str(), flags & ~O_DIRECT, 0644);
   }
+  if (fd < 0) {
+    return nullptr;
+  }
+  auto *segment = new Segment();
+  segment->fd_ = fd;
+  segment->file_size_ = std::max(GetFileSize(file_name), static_cast<int64_t>(0));
+  if (backend_ == DiskIOBackend::MMAP && segment->file_size_ > 0) {
+    void *mapping = mmap(nullptr, segment->file_size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      delete segment;
+      throw std::exception();
+    }
+    segment->mapping_ = static_cast<char *>(mapping);
+  }
+  segments_[index] = segment;
+  return segment;
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+DiskManager::Segment *DiskManager::LocateSegment(physical_page_id_t physical_page_id, size_t *offset) {
+  if (segment_pages_ == 0) {
+    *offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+    return segments_[0];
+  }
+  size_t index = static_cast<size_t>(physical_page_id) / segment_pages_;
+  ASSERT(index < max_segments_, "Invalid page id.");
+  *offset = static_cast<size_t>(physical_page_id) % segment_pages_ * PAGE_SIZE;
+  return segments_[index];
+}
+
+size_t DiskManager::PagesInSegment(physical_page_id_t physical_page_id, size_t count) const {
+  if (segment_pages_ == 0) {
+    return count;
+  }
+  return std::min(count, segment_pages_ - static_cast<size_t>(physical_page_id) % segment_pages_);
+}
+
+DiskManager::Segment *DiskManager::GrowFile(physical_page_id_t physical_page_id, size_t *offset) {
+  size_t page_offset;
+  Segment *segment = LocateSegment(physical_page_id, &page_offset);
+  if (offset != nullptr) {
+    *offset = page_offset;
+  }
+  size_t min_size = page_offset + PAGE_SIZE;
+  if (segment != nullptr && min_size <= segment->file_size_) {
+    return segment;
+  }
+  const size_t segment_size = segment_pages_ * PAGE_SIZE;
+  if (segment == nullptr) {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    size_t index = static_cast<size_t>(physical_page_id) / segment_pages_;
+    // the segments before it are filled up, so that the first file tells the segment size when the database is opened
+    for (size_t i = 0; i <= index; i++) {
+      Segment *previous = segments_[i];
+      if (previous == nullptr && (previous = OpenSegment(i, true)) == nullptr) {
+        LOG(ERROR) << "Failed to create " << GetSegmentFileName(file_name_, i);
+        return nullptr;
+      }
+      std::scoped_lock<std::mutex> grow_lock(previous->grow_latch_);
+      if (i < index && previous->file_size_ < segment_size) {
+        if (ftruncate(previous->fd_, segment_size) != 0) {
+          LOG(ERROR) << "Failed to grow the database file";
+        }
+        previous->file_size_ = segment_size;
+      }
+    }
+    segment = segments_[index];
+  }
+  std::scoped_lock<std::mutex> grow_lock(segment->grow_latch_);
+  size_t file_size = segment->file_size_;
+  if (min_size <= file_size) {
+    return segment;
+  }
+  const size_t chunk_size = static_cast<size_t>(DEFAULT_FILE_GROW_PAGES) * PAGE_SIZE;
+  size_t new_size = (min_size + chunk_size - 1) / chunk_size * chunk_size;
+  if (segment_pages_ != 0) {
+    new_size = std::min(new_size, segment_size);
+  }
+  // a write far beyond the end, e.g. the bitmap page of a new extent, leaves a hole instead of allocating the gap
+  size_t start = std::max(file_size, min_size - PAGE_SIZE);
+  if (start > file_size + chunk_size) {
+    // and nothing is preallocated until pages are written next to it, so that a large sparse file stays small on disk
+    new_size = min_size;
+    if (ftruncate(segment->fd_, new_size) != 0) {
+      LOG(ERROR) << "Failed to grow the database file";
+    }
+  } else if (fallocate(segment->fd_, 0, start, new_size - start) != 0 && ftruncate(segment->fd_, new_size) != 0) {
+    LOG(ERROR) << "Failed to grow the database file";
+    // the write itself still extends the file
+    new_size = min_size;
+  }
+  segment->file_size_ = new_size;
+  return segment;
+}
+
+void DiskManager::ReadPhysicalPage(physical_page_id_t physical_page_id, char *page_data) {
+  ReadPhysicalPages(physical_page_id, 1, page_data);
+}
+
+void DiskManager::ReadPhysicalPages(physical_page_id_t first_physical_page_id, size_t count, char *page_data) {
+  while (count > 0) {
+    size_t run = PagesInSegment(first_physical_page_id, count);
+    size_t offset;
+    Segment *segment = LocateSegment(first_physical_page_id, &offset);
+    size_t size = run * PAGE_SIZE;
+    size_t file_size = segment == nullptr ? 0 : segment->file_size_.load();
+    // only the part inside the file is read, pages beyond its end read as zeros
+    size_t read_size = offset < file_size ? std::min(size, file_size - offset) : 0;
+    size_t read_count = 0;
+    if (backend_ == DiskIOBackend::MMAP) {
+      if (read_size > 0) {
+        memcpy(page_data, segment->mapping_ + offset, read_size);
+      }
+      read_count = read_size;
+    } else if (IsPositional()) {
+      char *buffer = page_data;
+      std::unique_ptr<char, decltype(&free)> bounce(nullptr, &free);
+      if (backend_ == DiskIOBackend::DIRECT && !IsAligned(page_data) && read_size > 0) {
+        bounce.reset(static_cast<char *>(aligned_alloc(PAGE_SIZE, size)));
+        buffer = bounce.get();
+      }
+      while (read_count < read_size) {
+        ssize_t ret = pread(segment->fd_, buffer + read_count, read_size - read_count, offset + read_count);
+        if (ret < 0 && errno == EINTR) {
+          continue;
+        }
+        if (ret <= 0) {
+          LOG(ERROR) << "I/O error while reading";
+          break;
+        }
+        read_count += ret;
+      }
+      if (bounce != nullptr) {
+        memcpy(page_data, buffer, read_count);
+      }
+    } else if (read_size > 0) {
+      db_io_.seekp(offset);
+      db_io_.read(page_data, read_size);
+      read_count = db_io_.gcount();
+      db_io_.clear();
+    }
+    memset(page_data + read_count, 0, size - read_count);
+    first_physical_page_id += static_cast<physical_page_id_t>(run);
+    page_data += size;
+    count -= run;
+  }
+}
+
+void DiskManager::WritePhysicalPage(physical_page_id_t physical_page_id, const char *page_data) {
+  if (backend_ == DiskIOBackend::MMAP) {
+    // e.g. the buffer pool writes back every resident page on shutdown, only a modified page is an error
+    char file_data[PAGE_SIZE];
+    ReadPhysicalPage(physical_page_id, file_data);
+    if (memcmp(file_data, page_data, PAGE_SIZE) != 0) {
+      LOG(ERROR) << "Cannot write a page of a read-only database";
+    }
+    return;
+  }
+  size_t offset;
+  Segment *segment = GrowFile(physical_page_id, &offset);
+  if (segment == nullptr) {
+    return;
+  }
+  if (IsPositional()) {
+    std::unique_ptr<char, decltype(&free)> bounce(nullptr, &free);
+    if (backend_ == DiskIOBackend::DIRECT && !IsAligned(page_data)) {
+      bounce.reset(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)));
+      memcpy(bounce.get(), page_data, PAGE_SIZE);
+      page_data = bounce.get();
+    }
+    size_t write_count = 0;
+    while (write_count < PAGE_SIZE) {
+      ssize_t ret = pwrite(segment->fd_, page_data + write_count, PAGE_SIZE - write_count, offset + write_count);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret <= 0) {
+        LOG(ERROR) << "I/O error while writing";
+        return;
+      }
+      write_count += ret;
+    }
+    segment->unsynced_ = true;
+    AfterWrite();
+    return;
+  }
   // set write cursor to offset
   db_io_.seekp(offset);
   db_io_.write(page_data, PAGE_SIZE);
@@ -174,6 +717,189 @@ void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page
     LOG(ERROR) << "I/O error while writing";
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  segment->unsynced_ = true;
+  AfterWrite();
+}
+
+void DiskManager::WriteMetaPage() {
+  if (durability_mode_ == DurabilityMode::SYNC_EVERY_WRITE) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+  } else {
+    meta_dirty_ = true;
+  }
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetExtentBitmap(uint32_t extent_id) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id] = std::make_unique<BitmapPage<PAGE_SIZE>>();
+    ReadPhysicalPage(BitmapPhysicalPageId(extent_id), reinterpret_cast<char *>(bitmaps_[extent_id].get()));
+  }
+  return bitmaps_[extent_id].get();
+}
+
+void DiskManager::WriteExtentBitmap(uint32_t extent_id) {
+  if (durability_mode_ == DurabilityMode::SYNC_EVERY_WRITE) {
+    WritePhysicalPage(BitmapPhysicalPageId(extent_id), reinterpret_cast<const char *>(bitmaps_[extent_id].get()));
+  } else {
+    bitmap_dirty_[extent_id] = true;
+  }
+}
+
+uint32_t *DiskManager::GetExtentUsedPages(uint32_t extent_id) {
+  if (extent_id < META_PAGE_EXTENTS) {
+    return &reinterpret_cast<DiskFileMetaPage *>(meta_data_)->extent_used_page_[extent_id];
+  }
+  uint32_t index = (extent_id - META_PAGE_EXTENTS) / DIRECTORY_PAGE_EXTENTS;
+  if (index >= directory_pages_.size()) {
+    directory_pages_.resize(index + 1);
+    directory_dirty_.resize(index + 1, false);
+  }
+  if (directory_pages_[index] == nullptr) {
+    directory_pages_[index] = std::make_unique<DiskFileDirectoryPage>();
+    ReadPhysicalPage(DirectoryPhysicalPageId(index), reinterpret_cast<char *>(directory_pages_[index].get()));
+  }
+  return &directory_pages_[index]->extent_used_page_[(extent_id - META_PAGE_EXTENTS) % DIRECTORY_PAGE_EXTENTS];
+}
+
+void DiskManager::WriteExtentUsedPages(uint32_t extent_id) {
+  // the counters of the first extents are part of the meta page
+  if (extent_id < META_PAGE_EXTENTS) {
+    return;
+  }
+  uint32_t index = (extent_id - META_PAGE_EXTENTS) / DIRECTORY_PAGE_EXTENTS;
+  if (durability_mode_ == DurabilityMode::SYNC_EVERY_WRITE) {
+    WritePhysicalPage(DirectoryPhysicalPageId(index), reinterpret_cast<const char *>(directory_pages_[index].get()));
+  } else {
+    directory_dirty_[index] = true;
+  }
+}
+
+void DiskManager::AfterWrite(size_t count) {
+  switch (durability_mode_) {
+    case DurabilityMode::SYNC_EVERY_WRITE:
+      if (db_io_.is_open()) {
+        db_io_.flush();
+      }
+      SyncSegments();
+      break;
+    case DurabilityMode::GROUP_COMMIT:
+      if ((unsynced_writes_ += count) >= sync_batch_) {
+        sync_cv_.notify_one();
+      }
+      break;
+    default:
+      unsynced_writes_ += count;
+  }
+}
+
+void DiskManager::Sync() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  for (uint32_t extent_id = 0; extent_id < bitmap_dirty_.size(); extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      WritePhysicalPage(BitmapPhysicalPageId(extent_id), reinterpret_cast<const char *>(bitmaps_[extent_id].get()));
+      bitmap_dirty_[extent_id] = false;
+    }
+  }
+  for (uint32_t index = 0; index < directory_dirty_.size(); index++) {
+    if (directory_dirty_[index]) {
+      WritePhysicalPage(DirectoryPhysicalPageId(index), reinterpret_cast<const char *>(directory_pages_[index].get()));
+      directory_dirty_[index] = false;
+    }
+  }
+  if (meta_dirty_.exchange(false)) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+  }
+  if (db_io_.is_open()) {
+    db_io_.flush();
+  }
+  // writes that complete while fdatasync runs are left to the next sync
+  unsynced_writes_ = 0;
+  SyncSegments();
+  PunchHoles();
+}
+
+void DiskManager::SyncSegments() {
+  // the segments before the last one are all open, see GrowFile
+  for (size_t index = 0; index < max_segments_; index++) {
+    Segment *segment = segments_[index];
+    if (segment == nullptr) {
+      break;
+    }
+    if (segment->unsynced_.exchange(false)) {
+      fdatasync(segment->fd_);
+    }
+  }
+}
+
+void DiskManager::PunchHoles() {
+  std::sort(pending_holes_.begin(), pending_holes_.end());
+  size_t begin = 0;
+  while (begin < pending_holes_.size()) {
+    // a run of pages that are still free and adjacent in one segment
+    page_id_t first_page_id = pending_holes_[begin];
+    size_t end = begin;
+    while (end < pending_holes_.size() && IsPageFree(pending_holes_[end]) &&
+           pending_holes_[end] == first_page_id + static_cast<page_id_t>(end - begin) &&
+           pending_holes_[end] / BITMAP_SIZE == first_page_id / BITMAP_SIZE &&
+           PagesInSegment(MapPageId(first_page_id), end - begin + 1) == end - begin + 1) {
+      end++;
+    }
+    if (end == begin) {
+      // allocated again since it was freed
+      begin++;
+      continue;
+    }
+    size_t offset;
+    Segment *segment = LocateSegment(MapPageId(first_page_id), &offset);
+    if (segment != nullptr && offset < segment->file_size_) {
+      // nothing to do if the file system cannot punch holes
+      fallocate(segment->fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, (end - begin) * PAGE_SIZE);
+    }
+    begin = end;
+  }
+  pending_holes_.clear();
+}
+
+void DiskManager::SetDurabilityMode(DurabilityMode durability_mode, std::chrono::milliseconds sync_interval,
+                                    size_t sync_batch) {
+  StopSyncer();
+  Sync();
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  durability_mode_ = durability_mode;
+  sync_interval_ = sync_interval;
+  sync_batch_ = sync_batch;
+  if (durability_mode_ != DurabilityMode::GROUP_COMMIT) {
+    return;
+  }
+  syncer_running_ = true;
+  syncer_ = std::thread([this]() {
+    std::unique_lock<std::mutex> sync_lock(sync_latch_);
+    while (true) {
+      sync_cv_.wait_for(sync_lock, sync_interval_,
+                        [this]() { return !syncer_running_ || unsynced_writes_ >= sync_batch_; });
+      if (!syncer_running_) {
+        return;
+      }
+      if (unsynced_writes_ > 0 || meta_dirty_) {
+        sync_lock.unlock();
+        Sync();
+        sync_lock.lock();
+      }
+    }
+  });
+}
+
+void DiskManager::StopSyncer() {
+  {
+    std::scoped_lock<std::mutex> sync_lock(sync_latch_);
+    syncer_running_ = false;
+  }
+  sync_cv_.notify_all();
+  if (syncer_.joinable()) {
+    syncer_.join();
+  }
 }
\ No newline at end of file
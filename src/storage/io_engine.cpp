@@ -0,0 +1,345 @@
+#include "storage/io_engine.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+#include "glog/logging.h"
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#define MINISQL_HAVE_IO_URING
+#endif
+
+bool IOEngine::AcquireSlot(bool wait) {
+  std::unique_lock<std::mutex> lock(slot_latch_);
+  if (in_flight_ >= queue_depth_) {
+    if (!wait) {
+      return false;
+    }
+    slot_cv_.wait(lock, [this]() { return in_flight_ < queue_depth_; });
+  }
+  in_flight_++;
+  return true;
+}
+
+void IOEngine::Complete(IORequest &request, bool ok) {
+  if (!ok) {
+    LOG(ERROR) << "I/O error while " << (request.write_ ? "writing" : "reading") << " at offset " << request.offset_;
+  }
+  if (request.callback_) {
+    request.callback_(ok);
+  }
+  {
+    std::scoped_lock<std::mutex> lock(slot_latch_);
+    in_flight_--;
+  }
+  slot_cv_.notify_all();
+}
+
+void IOEngine::Drain() {
+  std::unique_lock<std::mutex> lock(slot_latch_);
+  slot_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+}
+
+bool IOEngine::FinishBlocking(IORequest &request, size_t done) {
+  int fd = request.fd_ < 0 ? fd_ : request.fd_;
+  std::vector<iovec> iov = request.iov_;
+  if (iov.empty()) {
+    iov.push_back({request.data_, request.size_});
+  }
+  // skip what has been transferred already
+  size_t index = 0;
+  size_t skip = done;
+  for (; index < iov.size() && skip >= iov[index].iov_len; index++) {
+    skip -= iov[index].iov_len;
+  }
+  while (index < iov.size()) {
+    iov[index].iov_base = static_cast<char *>(iov[index].iov_base) + skip;
+    iov[index].iov_len -= skip;
+    int count = static_cast<int>(iov.size() - index);
+    ssize_t ret = request.write_ ? pwritev(fd, &iov[index], count, request.offset_ + done)
+                                 : preadv(fd, &iov[index], count, request.offset_ + done);
+    if (ret < 0 && errno == EINTR) {
+      skip = 0;
+      continue;
+    }
+    if (ret < 0 || (ret == 0 && request.write_)) {
+      return false;
+    }
+    if (ret == 0) {
+      // end of file
+      for (; index < iov.size(); index++) {
+        memset(iov[index].iov_base, 0, iov[index].iov_len);
+      }
+      return true;
+    }
+    done += ret;
+    skip = ret;
+    for (; index < iov.size() && skip >= iov[index].iov_len; index++) {
+      skip -= iov[index].iov_len;
+    }
+  }
+  return true;
+}
+
+/**
+ * Blocking pread/pwrite on a few worker threads, the queue depth is bounded by the number of threads.
+ */
+class ThreadPoolIOEngine : public IOEngine {
+ public:
+  ThreadPoolIOEngine(int fd, size_t queue_depth) : IOEngine(fd, queue_depth) {
+    size_t thread_count = std::min(static_cast<size_t>(DEFAULT_IO_THREADS), queue_depth_);
+    for (size_t i = 0; i < thread_count; i++) {
+      workers_.emplace_back(&ThreadPoolIOEngine::Worker, this);
+    }
+  }
+
+  ~ThreadPoolIOEngine() override {
+    Drain();
+    {
+      std::scoped_lock<std::mutex> lock(queue_latch_);
+      running_ = false;
+    }
+    queue_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Submit(std::vector<IORequest> requests) override {
+    for (auto &request : requests) {
+      AcquireSlot();
+      {
+        std::scoped_lock<std::mutex> lock(queue_latch_);
+        queue_.push_back(std::move(request));
+      }
+      queue_cv_.notify_one();
+    }
+  }
+
+  IOEngineType GetType() const override { return IOEngineType::THREAD_POOL; }
+
+ private:
+  void Worker() {
+    std::unique_lock<std::mutex> lock(queue_latch_);
+    while (true) {
+      queue_cv_.wait(lock, [this]() { return !running_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      IORequest request = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      bool ok = FinishBlocking(request, 0);
+      Complete(request, ok);
+      lock.lock();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<IORequest> queue_;  // protected by queue_latch_
+  bool running_{true};           // protected by queue_latch_
+  std::mutex queue_latch_;
+  std::condition_variable queue_cv_;
+};
+
+#ifdef MINISQL_HAVE_IO_URING
+/**
+ * io_uring through the raw system calls: requests are written to the submission ring and handed to the kernel with
+ * one io_uring_enter per batch, a completion thread reaps the completion ring.
+ */
+class IoUringIOEngine : public IOEngine {
+ public:
+  IoUringIOEngine(int fd, size_t queue_depth) : IOEngine(fd, queue_depth) {}
+
+  ~IoUringIOEngine() override {
+    if (completer_.joinable()) {
+      Drain();
+      // a request without user data tells the completion thread to stop
+      {
+        std::scoped_lock<std::mutex> lock(submit_latch_);
+        PushRequest(IORING_OP_NOP, fd_, 0, nullptr, 0, 0);
+        Enter(1);
+      }
+      completer_.join();
+    }
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  /**
+   * Set up the rings and start the completion thread.
+   * @return false if io_uring is not available
+   */
+  bool Init() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth_), &params));
+    if (ring_fd_ < 0) {
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                  IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return false;
+    }
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    // the completion ring is at least as large as the submission ring, so in-flight requests never overflow it
+    queue_depth_ = std::min(queue_depth_, static_cast<size_t>(params.sq_entries));
+    completer_ = std::thread(&IoUringIOEngine::CompletionWorker, this);
+    return true;
+  }
+
+  void Submit(std::vector<IORequest> requests) override {
+    std::scoped_lock<std::mutex> lock(submit_latch_);
+    unsigned pending = 0;
+    for (auto &request : requests) {
+      if (!AcquireSlot(false)) {
+        // the queue is full, hand what we have to the kernel before waiting for a completion
+        Enter(pending);
+        pending = 0;
+        AcquireSlot();
+      }
+      auto *owned = new IORequest(std::move(request));
+      int fd = owned->fd_ < 0 ? fd_ : owned->fd_;
+      if (owned->iov_.empty()) {
+        PushRequest(owned->write_ ? IORING_OP_WRITE : IORING_OP_READ, fd, owned->offset_, owned->data_,
+                    owned->size_, reinterpret_cast<uint64_t>(owned));
+      } else {
+        // the iovec array stays with the owned request until it completes
+        PushRequest(owned->write_ ? IORING_OP_WRITEV : IORING_OP_READV, fd, owned->offset_,
+                    reinterpret_cast<char *>(owned->iov_.data()), owned->iov_.size(), reinterpret_cast<uint64_t>(owned));
+      }
+      pending++;
+    }
+    Enter(pending);
+  }
+
+  IOEngineType GetType() const override { return IOEngineType::IO_URING; }
+
+ private:
+  /** Write a submission queue entry, the caller holds submit_latch_. */
+  void PushRequest(uint8_t opcode, int fd, size_t offset, char *data, size_t size, uint64_t user_data) {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe &sqe = static_cast<io_uring_sqe *>(sqes_)[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.off = offset;
+    sqe.addr = reinterpret_cast<uint64_t>(data);
+    sqe.len = static_cast<uint32_t>(size);
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /** Submit count queued entries, the caller holds submit_latch_. */
+  void Enter(unsigned count) {
+    while (count > 0) {
+      long ret = syscall(__NR_io_uring_enter, ring_fd_, count, 0, 0, nullptr, 0);
+      if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+          continue;
+        }
+        LOG(FATAL) << "io_uring_enter failed: " << strerror(errno);
+      }
+      count -= static_cast<unsigned>(ret);
+    }
+  }
+
+  void CompletionWorker() {
+    while (true) {
+      unsigned head = *cq_head_;
+      if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+      io_uring_cqe cqe = cqes_[head & cq_mask_];
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      auto *request = reinterpret_cast<IORequest *>(cqe.user_data);
+      if (request == nullptr) {
+        return;
+      }
+      // errors and short transfers, e.g. a read across the end of the file, are finished with pread/pwrite
+      bool ok = cqe.res >= 0 ? FinishBlocking(*request, static_cast<size_t>(cqe.res))
+                             : (cqe.res == -EINTR || cqe.res == -EAGAIN) && FinishBlocking(*request, 0);
+      Complete(*request, ok);
+      delete request;
+    }
+  }
+
+  int ring_fd_{-1};
+  void *sq_ring_{MAP_FAILED};
+  void *cq_ring_{MAP_FAILED};
+  void *sqes_{MAP_FAILED};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+  std::mutex submit_latch_;
+  std::thread completer_;
+};
+#endif
+
+std::unique_ptr<IOEngine> IOEngine::Create(int fd, IOEngineType type, size_t queue_depth) {
+  queue_depth = std::max(queue_depth, static_cast<size_t>(1));
+#ifdef MINISQL_HAVE_IO_URING
+  if (type == IOEngineType::IO_URING) {
+    auto engine = std::make_unique<IoUringIOEngine>(fd, queue_depth);
+    if (engine->Init()) {
+      return engine;
+    }
+    LOG(WARNING) << "io_uring is not available, falling back to the thread pool I/O engine";
+  }
+#endif
+  return std::make_unique<ThreadPoolIOEngine>(fd, queue_depth);
+}
@@ -1,5 +1,7 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+
 /**
  * TODO: Student Implement
  */
@@ -9,36 +11,281 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn)
     {  
         return false;
     }
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(GetFirstPageId()));           //从buffer中取出第一个数据页（从堆表的第一个数据页开始遍历）
+    // 在空闲空间映射中找第一个放得下的数据页，而不是沿着链表逐页尝试
+    if (!LoadFreeSpaceMap())                                                                                //没有空闲空间映射就无法确定末尾的数据页
+    {
+        return false;
+    }
+    uint32_t size = row.GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
+    page_id_t page_id = FindFreePage(size);
     while (true) 
     {
+        bool grown = page_id == INVALID_PAGE_ID;
+        if (grown)                                                                                          //没有放得下的数据页，在堆表末尾追加一组新的数据页
+        {
+            page_id = GrowHeap(last_page_id_, fsm_entries_.size(), txn);
+            if (page_id == INVALID_PAGE_ID)
+            {
+                return false;
+            }
+        }
+        auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
         // If the page could not be found, then abort the transaction.
         if (page == nullptr)                                                                                
         {
             return false;
         }
-        if (page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_))                              //如果页中有空间可以插入，即page的InsertTuple函数返回true
+        bool inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+        UpdateFreeSpace(page_id, page->GetFreeSpaceRemaining());                                            //映射中记录的空闲空间可能是旧的，插入之后总是更新
+        buffer_pool_manager_->UnpinPage(page_id, inserted);                                                 //写入了数据的页是脏页
+        if (inserted)
         {
-            buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);                                  //写入后该页不再被调用，使用UnpinPage函数，将pin_count减一，由于这里写入了数据，所有该页变成了脏页，所以第二个参数is_dirty为true
-            return true;                                                                                    //插入成功后返回True
+            return true;
         }
-
-        buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);                                     //如果该页没有空间可以插入，使用UnpinPage函数，将pin_count减一，由于这里没有写入数据，所以第二个参数is_dirty为false
-        page_id_t next = page->GetNextPageId();                                                             //由于该页没有空间可以插入，所以要获取下一个数据页的id
-        if (next != INVALID_PAGE_ID)                                                                        //如果下一个数据页的id不是INVALID_PAGE_ID，说明还有下一个数据页
-        {
-            page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next));
-        } 
-        else                                                                                                //如果后面没有数据页了，就new一个数据页
+        if (grown)                                                                                          //空的数据页也放不下
         {
-            auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next));             //new一个数据页，将该页的page_id放在next中
-            page->SetNextPageId(next);                                                                      //将该页的next_page_id设置为next
-            new_page->Init(next, page->GetPageId(), log_manager_, txn);                                     //初始化该页，将该页插入到堆表中(其中第二个参数为prev_page_id)
-            new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);                          //将tuple插入到该页中
-            buffer_pool_manager_->UnpinPage(next, true);                                                    //写入后该页不再被调用，使用UnpinPage函数，将pin_count减一，由于这里写入了数据，所有该页变成了脏页，所以第二个参数is_dirty为true
-            return true;
+            return false;
         }
+        page_id = FindFreePage(size);
+    }
+}
+
+bool TableHeap::BulkInsert(std::vector<Row> &rows, Transaction *txn) {
+  if (!LoadFreeSpaceMap()) {
+    return false;
+  }
+  // pack the rows, page_begins holds the first row of every new page and the end of the rows
+  const uint32_t empty_page_room = TablePage::SIZE_MAX_ROW + TablePage::SIZE_TUPLE;
+  std::vector<size_t> page_begins;
+  uint32_t room = 0;
+  for (size_t i = 0; i < rows.size(); i++) {
+    uint32_t size = rows[i].GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
+    if (size > empty_page_room) {
+      return false;
+    }
+    if (size > room) {
+      page_begins.push_back(i);
+      room = empty_page_room;
+    }
+    room -= size;
+  }
+  const size_t page_count = page_begins.size();
+  page_begins.push_back(rows.size());
+
+  size_t page = 0;
+  std::vector<uint32_t> free_spaces;
+  while (page < page_count) {
+    size_t count = std::min<size_t>(page_count - page, DEFAULT_HEAP_GROW_MAX_PAGES);
+    if (!ReserveFreeSpaceEntries(count)) {
+      return false;
+    }
+    page_id_t prev_page_id;
+    size_t filled;
+    auto fill = [&](Page *new_page) {
+      auto table_page = reinterpret_cast<TablePage *>(new_page);
+      table_page->Init(new_page->GetPageId(), prev_page_id, log_manager_, txn);
+      for (size_t i = page_begins[page + filled]; i < page_begins[page + filled + 1]; i++) {
+        [[maybe_unused]] bool inserted = table_page->InsertTuple(rows[i], schema_, txn, lock_manager_, log_manager_);
+        ASSERT(inserted, "Rows packed for a page must fit in it.");
+      }
+      if (++filled < count) {
+        table_page->SetNextPageId(new_page->GetPageId() + 1);
+      }
+      free_spaces.push_back(table_page->GetFreeSpaceRemaining());
+      prev_page_id = new_page->GetPageId();
+    };
+    page_id_t first_page_id;
+    while (true) {
+      prev_page_id = last_page_id_;
+      filled = 0;
+      free_spaces.clear();
+      first_page_id = buffer_pool_manager_->NewPages(count, fill);
+      if (first_page_id != INVALID_PAGE_ID || count == 1) {
+        break;
+      }
+      // no free run that long, try a shorter one
+      count /= 2;
+    }
+    if (first_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+    last_page->SetNextPageId(first_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id_, true);
+    for (size_t i = 0; i < count; i++) {
+      AppendFreeSpaceEntry(first_page_id + static_cast<page_id_t>(i), free_spaces[i]);
     }
+    last_page_id_ = first_page_id + static_cast<page_id_t>(count) - 1;
+    page += count;
+  }
+  return true;
+}
+
+page_id_t TableHeap::GrowHeap(page_id_t last_page_id, size_t page_count, Transaction *txn) {
+  size_t count = std::clamp<size_t>(page_count, DEFAULT_HEAP_GROW_MIN_PAGES, DEFAULT_HEAP_GROW_MAX_PAGES);
+  if (!ReserveFreeSpaceEntries(count)) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t prev_page_id = last_page_id;
+  size_t initialized = 0;
+  uint32_t free_space = 0;
+  auto init = [&](Page *page) {
+    auto table_page = reinterpret_cast<TablePage *>(page);
+    table_page->Init(page->GetPageId(), prev_page_id, log_manager_, txn);
+    free_space = table_page->GetFreeSpaceRemaining();
+    // the pages of a run are consecutive
+    if (++initialized < count) {
+      table_page->SetNextPageId(page->GetPageId() + 1);
+    }
+    prev_page_id = page->GetPageId();
+  };
+  page_id_t first_page_id = buffer_pool_manager_->NewPages(count, init);
+  if (first_page_id == INVALID_PAGE_ID) {
+    // no free run or too few free frames, grow by a single page
+    count = 1;
+    initialized = 0;
+    prev_page_id = last_page_id;
+    Page *page = buffer_pool_manager_->NewPage(first_page_id);
+    if (page == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+    init(page);
+    buffer_pool_manager_->UnpinPage(first_page_id, true);
+  }
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  last_page->SetNextPageId(first_page_id);
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  for (size_t i = 0; i < count; i++) {
+    AppendFreeSpaceEntry(first_page_id + static_cast<page_id_t>(i), free_space);
+  }
+  last_page_id_ = first_page_id + static_cast<page_id_t>(count) - 1;
+  return first_page_id;
+}
+
+bool TableHeap::LoadFreeSpaceMap() {
+  if (fsm_loaded_) {
+    return true;
+  }
+  if (fsm_page_id_ == INVALID_PAGE_ID) {
+    std::vector<std::pair<page_id_t, uint32_t>> pages;
+    page_id_t page_id = first_page_id_;
+    while (page_id != INVALID_PAGE_ID) {
+      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      pages.emplace_back(page_id, page->GetFreeSpaceRemaining());
+      page_id_t next_page_id = page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    if (!ReserveFreeSpaceEntries(pages.size())) {
+      // give back the map pages taken so far, the next call starts over
+      for (auto fsm_page_id : fsm_page_ids_) {
+        buffer_pool_manager_->DeletePage(fsm_page_id);
+      }
+      fsm_page_ids_.clear();
+      fsm_max_buckets_.clear();
+      fsm_page_id_ = INVALID_PAGE_ID;
+      return false;
+    }
+    for (auto &page : pages) {
+      AppendFreeSpaceEntry(page.first, page.second);
+      last_page_id_ = page.first;
+    }
+    fsm_loaded_ = true;
+    return true;
+  }
+  fsm_loaded_ = true;
+  page_id_t fsm_page_id = fsm_page_id_;
+  while (fsm_page_id != INVALID_PAGE_ID) {
+    auto fsm_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_id)->GetData());
+    const uint32_t first_entry = fsm_page_ids_.size() * FreeSpaceMapPage::MAX_ENTRY_COUNT;
+    for (uint32_t i = 0; i < fsm_page->GetEntryCount(); i++) {
+      fsm_entries_[fsm_page->GetPageIdAt(i)] = first_entry + i;
+      last_page_id_ = fsm_page->GetPageIdAt(i);
+    }
+    fsm_page_ids_.push_back(fsm_page_id);
+    fsm_max_buckets_.push_back(fsm_page->GetMaxBucket());
+    page_id_t next_page_id = fsm_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(fsm_page_id, false);
+    fsm_page_id = next_page_id;
+  }
+  return true;
+}
+
+bool TableHeap::ReserveFreeSpaceEntries(size_t count) {
+  while (fsm_entries_.size() + count > fsm_page_ids_.size() * FreeSpaceMapPage::MAX_ENTRY_COUNT) {
+    page_id_t fsm_page_id;
+    Page *page = buffer_pool_manager_->NewPage(fsm_page_id);
+    if (page == nullptr) {
+      return false;
+    }
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+    if (fsm_page_ids_.empty()) {
+      fsm_page_id_ = fsm_page_id;
+    } else {
+      auto last_fsm_page =
+          reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_.back())->GetData());
+      last_fsm_page->SetNextPageId(fsm_page_id);
+      buffer_pool_manager_->UnpinPage(fsm_page_ids_.back(), true);
+    }
+    fsm_page_ids_.push_back(fsm_page_id);
+    fsm_max_buckets_.push_back(0);
+  }
+  return true;
+}
+
+void TableHeap::AppendFreeSpaceEntry(page_id_t page_id, uint32_t free_space) {
+  const uint32_t entry = fsm_entries_.size();
+  const uint32_t fsm_index = entry / FreeSpaceMapPage::MAX_ENTRY_COUNT;
+  ASSERT(fsm_index < fsm_page_ids_.size(), "No room reserved in the free space map.");
+  uint8_t bucket = FreeSpaceMapPage::ToBucket(free_space);
+  auto fsm_page =
+      reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_[fsm_index])->GetData());
+  fsm_page->Append(page_id, bucket);
+  buffer_pool_manager_->UnpinPage(fsm_page_ids_[fsm_index], true);
+  fsm_max_buckets_[fsm_index] = std::max(fsm_max_buckets_[fsm_index], bucket);
+  fsm_entries_[page_id] = entry;
+}
+
+void TableHeap::UpdateFreeSpace(page_id_t page_id, uint32_t free_space) {
+  LoadFreeSpaceMap();
+  auto iter = fsm_entries_.find(page_id);
+  if (iter == fsm_entries_.end()) {
+    return;
+  }
+  const uint32_t fsm_index = iter->second / FreeSpaceMapPage::MAX_ENTRY_COUNT;
+  const uint32_t slot = iter->second % FreeSpaceMapPage::MAX_ENTRY_COUNT;
+  uint8_t bucket = FreeSpaceMapPage::ToBucket(free_space);
+  auto fsm_page =
+      reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_[fsm_index])->GetData());
+  bool is_dirty = fsm_page->GetBucketAt(slot) != bucket;
+  fsm_page->SetBucketAt(slot, bucket);
+  buffer_pool_manager_->UnpinPage(fsm_page_ids_[fsm_index], is_dirty);
+  // the bound only grows here, a search that finds nothing on the map page makes it exact again
+  fsm_max_buckets_[fsm_index] = std::max(fsm_max_buckets_[fsm_index], bucket);
+}
+
+page_id_t TableHeap::FindFreePage(uint32_t size) {
+  LoadFreeSpaceMap();
+  uint8_t bucket = FreeSpaceMapPage::ToBucketRoundUp(size);
+  for (size_t i = 0; i < fsm_page_ids_.size(); i++) {
+    if (fsm_max_buckets_[i] < bucket) {
+      continue;
+    }
+    auto fsm_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_[i])->GetData());
+    uint32_t slot = fsm_page->FindBucket(bucket);
+    page_id_t page_id = INVALID_PAGE_ID;
+    if (slot < fsm_page->GetEntryCount()) {
+      page_id = fsm_page->GetPageIdAt(slot);
+    } else {
+      fsm_max_buckets_[i] = fsm_page->GetMaxBucket();
+    }
+    buffer_pool_manager_->UnpinPage(fsm_page_ids_[i], false);
+    if (page_id != INVALID_PAGE_ID) {
+      return page_id;
+    }
+  }
+  return INVALID_PAGE_ID;
 }
 
 
@@ -71,6 +318,7 @@ bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn)
     }
 
     page->UpdateTuple(row, &old, schema_, txn, lock_manager_, log_manager_);                             //调用该页的UpdateTuple函数，更新该页中的tuple
+    UpdateFreeSpace(page->GetTablePageId(), page->GetFreeSpaceRemaining());
 
     buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);                                              //写入后该页不再被调用，使用UnpinPage函数，将pin_count减一，由于这里写入了数据，所有该页变成了脏页，所以第二个参数is_dirty为true
     return true;
@@ -90,6 +338,7 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn)
     page->WLatch();
     page->ApplyDelete(rid, txn, log_manager_);                                                                      //调用该页的ApplyDelete函数，将该页中的tuple删除
     page->WUnlatch();
+    UpdateFreeSpace(page->GetTablePageId(), page->GetFreeSpaceRemaining());                                         //删除的空间可以被之后的插入使用
     buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);                                                  //写入后该页不再被调用，使用UnpinPage函数，将pin_count减一，由于这里删除了一条记录，所以该页变成了脏页，所以第二个参数is_dirty为true
 }
 
@@ -126,22 +375,133 @@ void TableHeap::DeleteTable(page_id_t page_id) {
     buffer_pool_manager_->UnpinPage(page_id, false);
     buffer_pool_manager_->DeletePage(page_id);
   } else {
+    std::vector<page_id_t> fsm_page_ids;
+    GetFreeSpaceMapPageIds(&fsm_page_ids);
     DeleteTable(first_page_id_);
+    for (auto fsm_page_id : fsm_page_ids) {
+      buffer_pool_manager_->DeletePage(fsm_page_id);
+    }
   }
 }
 
+void TableHeap::GetPageIds(std::vector<page_id_t> *page_ids) {
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids->push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+size_t TableHeap::GetContiguousPages(page_id_t page_id, size_t max_count) {
+  // building a missing map writes pages, a scan only reads one that exists
+  if (fsm_page_id_ == INVALID_PAGE_ID || !LoadFreeSpaceMap()) {
+    return 0;
+  }
+  auto iter = fsm_entries_.find(page_id);
+  if (iter == fsm_entries_.end()) {
+    return 0;
+  }
+  size_t count = 0;
+  while (count < max_count) {
+    auto next = fsm_entries_.find(page_id + static_cast<page_id_t>(count) + 1);
+    if (next == fsm_entries_.end() || next->second != iter->second + count + 1) {
+      break;
+    }
+    count++;
+  }
+  return count;
+}
+
+void TableHeap::RelocatePage(page_id_t old_page_id, page_id_t new_page_id) {
+  auto old_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
+  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_page_id));
+  memcpy(new_page->GetData(), old_page->GetData(), PAGE_SIZE);
+  new_page->SetTablePageId(new_page_id);
+  page_id_t prev_page_id = new_page->GetPrevPageId();
+  page_id_t next_page_id = new_page->GetNextPageId();
+  buffer_pool_manager_->UnpinPage(old_page_id, false);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  if (old_page_id == first_page_id_) {
+    first_page_id_ = new_page_id;
+  } else if (prev_page_id != INVALID_PAGE_ID) {
+    auto prev_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+    prev_page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  }
+  if (next_page_id != INVALID_PAGE_ID) {
+    auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    next_page->SetPrevPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(next_page_id, true);
+  }
+  LoadFreeSpaceMap();
+  if (last_page_id_ == old_page_id) {
+    last_page_id_ = new_page_id;
+  }
+  auto iter = fsm_entries_.find(old_page_id);
+  if (iter == fsm_entries_.end()) {
+    return;
+  }
+  const uint32_t entry = iter->second;
+  fsm_entries_.erase(iter);
+  fsm_entries_[new_page_id] = entry;
+  page_id_t fsm_page_id = fsm_page_ids_[entry / FreeSpaceMapPage::MAX_ENTRY_COUNT];
+  auto fsm_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_id)->GetData());
+  fsm_page->SetPageIdAt(entry % FreeSpaceMapPage::MAX_ENTRY_COUNT, new_page_id);
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+}
+
+page_id_t TableHeap::GetFreeSpaceMapPageId() {
+  LoadFreeSpaceMap();
+  return fsm_page_id_;
+}
+
+void TableHeap::GetFreeSpaceMapPageIds(std::vector<page_id_t> *page_ids) {
+  LoadFreeSpaceMap();
+  page_ids->insert(page_ids->end(), fsm_page_ids_.begin(), fsm_page_ids_.end());
+}
+
+void TableHeap::RelocateFreeSpaceMapPage(page_id_t old_page_id, page_id_t new_page_id) {
+  LoadFreeSpaceMap();
+  auto iter = std::find(fsm_page_ids_.begin(), fsm_page_ids_.end(), old_page_id);
+  if (iter == fsm_page_ids_.end()) {
+    return;
+  }
+  Page *old_page = buffer_pool_manager_->FetchPage(old_page_id);
+  Page *new_page = buffer_pool_manager_->FetchPage(new_page_id);
+  memcpy(new_page->GetData(), old_page->GetData(), PAGE_SIZE);
+  buffer_pool_manager_->UnpinPage(old_page_id, false);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  if (iter == fsm_page_ids_.begin()) {
+    fsm_page_id_ = new_page_id;
+  } else {
+    auto prev_fsm_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(*(iter - 1))->GetData());
+    prev_fsm_page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(*(iter - 1), true);
+  }
+  *iter = new_page_id;
+}
+
 /**
  * TODO: Student Implement
  */
-TableIterator TableHeap::Begin(Transaction *txn) 
+TableIterator TableHeap::Begin(Transaction *txn, BufferAccessStrategy *strategy) 
 {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));                 //从buffer中取出第一个数据页
     RowId rid;
-    page->RLatch();
-    page->GetFirstTupleRid(&rid);                                                                               //调用该页的GetFirstTupleRid函数，获取该页中第一条记录的rid
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(first_page_id_, false);                                                     //使用UnpinPage函数，将pin_count减一，由于这里没有写入数据，所以第二个参数is_dirty为false
-    return TableIterator(this, rid);
+    page_id_t page_id = first_page_id_;
+    while (page_id != INVALID_PAGE_ID)                                                                          //第一页可能没有记录（如删空或批量插入到空表），向后找到第一条记录
+    {
+        auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy));          //从buffer中取出数据页
+        page->RLatch();
+        bool found = page->GetFirstTupleRid(&rid);                                                              //调用该页的GetFirstTupleRid函数，获取该页中第一条记录的rid
+        page_id_t next_page_id = page->GetNextPageId();
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(page_id, false);                                                        //使用UnpinPage函数，将pin_count减一，由于这里没有写入数据，所以第二个参数is_dirty为false
+        page_id = found ? INVALID_PAGE_ID : next_page_id;
+    }
+    return TableIterator(this, rid, strategy);
 }
 
 /**
@@ -1,12 +1,15 @@
 #include "storage/table_iterator.h"
 
+#include <utility>
+
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator(TableHeap *TbHeap, RowId rowid) : table_heap(TbHeap) 
+TableIterator::TableIterator(TableHeap *TbHeap, RowId rowid, BufferAccessStrategy *strategy)
+    : table_heap(TbHeap), strategy_(strategy)
 {
       if (rowid.GetPageId() != INVALID_PAGE_ID && TbHeap != nullptr)  //如果rid的page_id不是INVALID_PAGE_ID，说明该rid是有效的
       {
@@ -23,6 +26,9 @@ TableIterator::TableIterator(const TableIterator &other) //拷贝构造函数
 { 
     table_heap = other.table_heap;
     row = other.row;
+    strategy_ = other.strategy_;
+    read_ahead_page_id_ = other.read_ahead_page_id_;
+    read_ahead_pages_ = other.read_ahead_pages_;
 }
 
 TableIterator::~TableIterator() {}
@@ -64,6 +70,9 @@ Row *TableIterator::operator->() {
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
     table_heap = itr.table_heap;
     row = itr.row;
+    strategy_ = itr.strategy_;
+    read_ahead_page_id_ = itr.read_ahead_page_id_;
+    read_ahead_pages_ = itr.read_ahead_pages_;
     return *this;
 }
 
@@ -79,6 +88,7 @@ TableIterator &TableIterator::operator++() {
     auto page = reinterpret_cast<TablePage *>(table_heap->buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId())); // 获取当前页
     RowId new_id;
     page->RLatch();
+    ReadAhead(page);
     if (page->GetNextTupleRid(row->GetRowId(), &new_id)) { // 如果当前页有下一个tuple
         delete row;
         row = new Row(new_id);
@@ -95,11 +105,12 @@ TableIterator &TableIterator::operator++() {
         page_id_t next_page_id = page->GetNextPageId();
         while (next_page_id != INVALID_PAGE_ID) {
             // 还没到最后一页
-            auto new_page = reinterpret_cast<TablePage *>(table_heap->buffer_pool_manager_->FetchPage(next_page_id));
+            auto new_page = reinterpret_cast<TablePage *>(table_heap->buffer_pool_manager_->FetchPage(next_page_id, strategy_));
             page->RUnlatch();
-            table_heap->buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false); // 释放上一页
+            table_heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false); // 释放上一页
             page = new_page;
             page->RLatch();
+            ReadAhead(page);
             if (page->GetFirstTupleRid(&new_id)) {
                 // 如果找到可用的tuple则跳出循环并读rowid
                 delete row;
@@ -118,14 +129,78 @@ TableIterator &TableIterator::operator++() {
             row = new Row(INVALID_ROWID);
         }
         page->RUnlatch();
-        table_heap->buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false);// 释放当前页
+        table_heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);// 释放当前页
     }
     return *this;
 }
 
+namespace {
+
+/**
+ * Keep the read-ahead window of the buffer pool in flight ahead of the heap page a scan has just moved to. The pages
+ * that are adjacent both in the heap and in the file are read as one range, all of them in flight at once; the chain is
+ * only followed from where the heap jumps elsewhere in the file.
+ * @param read_ahead_pages pages the scan has already requested ahead of the page, updated
+ */
+void ReadAheadChain(BufferPoolManager *bpm, TableHeap *table_heap, TablePage *page, size_t *read_ahead_pages) {
+    size_t window = bpm->GetReadAheadWindow();
+    if (*read_ahead_pages > 0) {
+        (*read_ahead_pages)--;
+    }
+    // top the window up once half of it has been consumed
+    if (window == 0 || *read_ahead_pages > window / 2 || page->GetNextPageId() == INVALID_PAGE_ID) {
+        return;
+    }
+    page_id_t page_id = page->GetTablePageId();
+    size_t run = table_heap->GetContiguousPages(page_id, window);
+    if (run > 0) {
+        bpm->PrefetchRange(page_id + 1, run);
+    }
+    if (run < window) {
+        // the last page of the run is read by then, the chain continues from its next page
+        bpm->PrefetchChain(page_id + static_cast<page_id_t>(run), window - run + 1, TablePage::OFFSET_NEXT_PAGE_ID);
+    }
+    *read_ahead_pages = window;
+}
+
+}  // namespace
+
+void TableIterator::ReadAhead(TablePage *page) {
+    if (page->GetTablePageId() == read_ahead_page_id_) {
+        return;
+    }
+    read_ahead_page_id_ = page->GetTablePageId();
+    ReadAheadChain(table_heap->buffer_pool_manager_, table_heap, page, &read_ahead_pages_);
+}
+
 // iter++
 TableIterator TableIterator::operator++(int) {
-    TableIterator newit(table_heap, row->GetRowId());
+    TableIterator newit(table_heap, row->GetRowId(), strategy_);
     ++(*this);
     return TableIterator{newit};
-}
\ No newline at end of file
+}
+
+TableBatchIterator::TableBatchIterator(TableHeap *table_heap, BufferAccessStrategy *strategy, RowFilter filter)
+    : table_heap_(table_heap),
+      strategy_(strategy),
+      filter_(std::move(filter)),
+      next_page_id_(table_heap == nullptr ? INVALID_PAGE_ID : table_heap->GetFirstPageId()) {}
+
+bool TableBatchIterator::NextBatch() {
+    batch_size_ = 0;
+    while (batch_size_ == 0 && next_page_id_ != INVALID_PAGE_ID) {
+        auto bpm = table_heap_->buffer_pool_manager_;
+        auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(next_page_id_, strategy_));
+        if (page == nullptr) {
+            next_page_id_ = INVALID_PAGE_ID;
+            break;
+        }
+        page->RLatch();
+        ReadAheadChain(bpm, table_heap_, page, &read_ahead_pages_);
+        batch_size_ = page->GetTuples(&batch_, table_heap_->schema_, filter_);
+        next_page_id_ = page->GetNextPageId();
+        page->RUnlatch();
+        bpm->UnpinPage(page->GetTablePageId(), false);
+    }
+    return batch_size_ > 0;
+}
@@ -0,0 +1,127 @@
+#include "buffer/buffer_access_strategy.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace {
+const char kMarker[] = "resident";
+
+/**
+ * Write a marker into the in-memory copy of every hot page without marking it dirty. A page that gets evicted and
+ * read back from disk loses its marker, so the marker tells whether the page stayed resident.
+ */
+void MarkResident(BufferPoolManager *bpm, const std::vector<page_id_t> &hot_pages) {
+  for (auto page_id : hot_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    std::memcpy(page->GetData(), kMarker, sizeof(kMarker));
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+size_t CountResident(BufferPoolManager *bpm, const std::vector<page_id_t> &hot_pages) {
+  size_t resident = 0;
+  for (auto page_id : hot_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    resident += std::memcmp(page->GetData(), kMarker, sizeof(kMarker)) == 0 ? 1 : 0;
+    bpm->UnpinPage(page_id, false);
+  }
+  return resident;
+}
+
+void Scan(BufferPoolManager *bpm, page_id_t num_pages, BufferAccessStrategy *strategy) {
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    Page *page = bpm->FetchPage(page_id, strategy);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(page_id, page->GetPageId());
+    ASSERT_EQ(page_id, *reinterpret_cast<page_id_t *>(page->GetData()));
+    bpm->UnpinPage(page_id, false);
+  }
+}
+}  // namespace
+
+TEST(BufferAccessStrategyTest, ScanKeepsWorkingSetTest) {
+  const std::string db_name = "bas_test.db";
+  const size_t buffer_pool_size = 64;
+  const page_id_t num_scan_pages = 1000;
+  const size_t num_hot_pages = 16;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < num_scan_pages; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_id;
+    bpm->UnpinPage(page_id, true);
+  }
+  std::vector<page_id_t> hot_pages;
+  for (size_t i = 0; i < num_hot_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+    bpm->FlushPage(page_id);
+    hot_pages.push_back(page_id);
+  }
+
+  // Scenario: a scan through a ring of 8 frames leaves the hot pages in the pool.
+  MarkResident(bpm, hot_pages);
+  BufferAccessStrategy strategy(8);
+  Scan(bpm, num_scan_pages, &strategy);
+  EXPECT_EQ(num_hot_pages, CountResident(bpm, hot_pages));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: the same scan through the shared pool evicts every hot page.
+  MarkResident(bpm, hot_pages);
+  Scan(bpm, num_scan_pages, nullptr);
+  EXPECT_EQ(0, CountResident(bpm, hot_pages));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferAccessStrategyTest, PinnedRingFrameTest) {
+  const std::string db_name = "bas_test.db";
+  const size_t buffer_pool_size = 4;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 8; i++) {
+    Page *page = bpm->NewPage(page_id);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_id;
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: a ring frame that is still pinned is never recycled, the scan takes another frame instead.
+  BufferAccessStrategy strategy(1);
+  Page *page0 = bpm->FetchPage(0, &strategy);
+  ASSERT_NE(nullptr, page0);
+  Page *page1 = bpm->FetchPage(1, &strategy);
+  ASSERT_NE(nullptr, page1);
+  EXPECT_NE(page0, page1);
+  EXPECT_EQ(0, *reinterpret_cast<page_id_t *>(page0->GetData()));
+  EXPECT_EQ(1, *reinterpret_cast<page_id_t *>(page1->GetData()));
+  bpm->UnpinPage(0, false);
+  bpm->UnpinPage(1, false);
+
+  // Once unpinned, the frame of the ring slot is reused for the next page.
+  Page *page2 = bpm->FetchPage(2, &strategy);
+  EXPECT_EQ(page1, page2);
+  EXPECT_EQ(2, *reinterpret_cast<page_id_t *>(page2->GetData()));
+  bpm->UnpinPage(2, false);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,158 @@
+#include "buffer/buffer_pool_manager.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/**
+ * Benchmark: the same buffer pool over buffered I/O and over O_DIRECT, with and without huge pages. The table is twice
+ * the size of the pool and scanned three times, starting from a cold OS page cache. With buffered I/O the pages read by
+ * the pool stay in the page cache as well, so the later scans are served from memory but every page the pool holds is
+ * held twice; with O_DIRECT each page is held once and every miss goes to the device. Effective capacity counts the
+ * distinct pages in memory against the memory they use.
+ */
+TEST(BufferPoolManagerBenchmark, DirectIOBenchmark) {
+  const std::string db_name = "bpm_benchmark.db";
+  const std::string resident_file_name = "bpm_benchmark.resident";
+  const size_t buffer_pool_size = 4096;
+  const page_id_t num_pages = 8192;
+  remove(db_name.c_str());
+  {
+    DiskManager disk_manager(db_name);
+    char data[PAGE_SIZE];
+    memset(data, 0, PAGE_SIZE);
+    for (page_id_t i = 0; i < num_pages; i++) {
+      disk_manager.AllocatePage();
+      *reinterpret_cast<page_id_t *>(data) = i;
+      disk_manager.WritePage(i, data);
+    }
+  }
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  const std::pair<DiskIOBackend, bool> configs[] = {
+      {DiskIOBackend::POSITIONAL, false}, {DiskIOBackend::DIRECT, false}, {DiskIOBackend::DIRECT, true}};
+  for (auto &[backend, huge_pages] : configs) {
+    // drop the file from the OS page cache
+    int fd = open(db_name.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    DiskManager disk_manager(db_name, backend);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, &disk_manager, ReplacerType::LRU, huge_pages);
+    double scan_ms[3];
+    size_t mismatches = 0;
+    for (double &ms : scan_ms) {
+      auto start = std::chrono::steady_clock::now();
+      for (page_id_t i = 0; i < num_pages; i++) {
+        Page *page = bpm->FetchPage(i);
+        mismatches += *reinterpret_cast<page_id_t *>(page->GetData()) != i ? 1 : 0;
+        bpm->UnpinPage(i, false);
+      }
+      ms = elapsed_ms(start);
+    }
+    EXPECT_EQ(0, mismatches);
+
+    // pages of the file in the OS page cache, and how many of them the pool holds as well
+    size_t file_size = lseek(fd, 0, SEEK_END);
+    void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    ASSERT_NE(MAP_FAILED, mapping);
+    std::vector<unsigned char> cached(file_size / PAGE_SIZE);
+    ASSERT_EQ(0, mincore(mapping, file_size, cached.data()));
+    munmap(mapping, file_size);
+    close(fd);
+    ASSERT_TRUE(bpm->DumpResidentPages(resident_file_name));
+    std::ifstream in(resident_file_name);
+    size_t pool_pages = 0;
+    size_t duplicated = 0;
+    for (page_id_t page_id; in >> page_id; pool_pages++) {
+      // logical to physical page id: the meta page and one bitmap page per extent come first
+      size_t physical_page_id = page_id + 2 + page_id / DiskManager::BITMAP_SIZE;
+      duplicated += cached[physical_page_id] & 1;
+    }
+    size_t cached_pages = std::count_if(cached.begin(), cached.end(), [](unsigned char page) { return page & 1; });
+    size_t distinct = pool_pages + cached_pages - duplicated;
+    const double mb = num_pages * PAGE_SIZE / 1048576.0;
+    std::printf("%-21s: cold scan %7.1f MB/s, repeated scans %7.1f / %7.1f MB/s; pool %zu pages + page cache %zu "
+                "pages, %zu held twice, effective capacity %.0f%%\n",
+                backend == DiskIOBackend::DIRECT ? (huge_pages ? "O_DIRECT + huge pages" : "O_DIRECT") : "buffered",
+                mb / scan_ms[0] * 1000, mb / scan_ms[1] * 1000, mb / scan_ms[2] * 1000, pool_pages, cached_pages,
+                duplicated, 100.0 * distinct / (pool_pages + cached_pages));
+    delete bpm;
+  }
+  remove(resident_file_name.c_str());
+  remove(db_name.c_str());
+}
+
+/**
+ * Benchmark: write back a pool full of dirty pages with one FlushPage per page, as the destructor used to, and with
+ * FlushAllPages, each followed by a sync of the file.
+ */
+TEST(BufferPoolManagerBenchmark, FlushAllPagesBenchmark) {
+  const std::string db_name = "bpm_flush_benchmark.db";
+  const size_t buffer_pool_size = 8192;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids(buffer_pool_size);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  auto dirty_all = [&](int round) {
+    for (auto page_id : page_ids) {
+      Page *page = bpm->FetchPage(page_id);
+      *reinterpret_cast<int *>(page->GetData()) = round;
+      *reinterpret_cast<page_id_t *>(page->GetData() + sizeof(int)) = page_id;
+      bpm->UnpinPage(page_id, true);
+    }
+  };
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  dirty_all(1);
+  // the page table hands the pages out in no particular order
+  std::vector<page_id_t> flush_order(page_ids);
+  std::shuffle(flush_order.begin(), flush_order.end(), std::mt19937(0));
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : flush_order) {
+    bpm->FlushPage(page_id);
+  }
+  disk_manager->Sync();
+  double per_page_ms = elapsed_ms(start);
+
+  dirty_all(2);
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(buffer_pool_size, bpm->FlushAllPages());
+  double batch_ms = elapsed_ms(start);
+  // everything is clean now
+  EXPECT_EQ(0, bpm->FlushAllPages());
+  const double mb = buffer_pool_size * PAGE_SIZE / 1048576.0;
+  std::printf("flush %zu dirty pages: FlushPage each %7.1f ms (%6.1f MB/s), FlushAllPages %7.1f ms (%6.1f MB/s)\n",
+              buffer_pool_size, per_page_ms, mb / per_page_ms * 1000, batch_ms, mb / batch_ms * 1000);
+
+  // Scenario: the pages written by the batch are read back after a restart, including a page dirtied afterwards.
+  dirty_all(3);
+  delete bpm;
+  delete disk_manager;
+  disk_manager = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    disk_manager->ReadPage(page_id, data);
+    ASSERT_EQ(3, *reinterpret_cast<int *>(data));
+    ASSERT_EQ(page_id, *reinterpret_cast<page_id_t *>(data + sizeof(int)));
+  }
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -1,8 +1,11 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -71,4 +74,275 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+TEST(BufferPoolManagerTest, BackgroundCleanerTest) {
+  const std::string db_name = "bpm_cleaner_test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 2000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->EnableBackgroundCleaner(0.5, std::chrono::milliseconds(1));
+
+  // Scenario: a steady insert load, every new page evicts a dirty one once the pool is full.
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<int *>(page->GetData()) = i;
+    bpm->UnpinPage(page_id, true);
+    if (i % 16 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+  bpm->DisableBackgroundCleaner();
+  EXPECT_GT(bpm->GetBackgroundWritebacks(), bpm->GetForegroundWritebacks() * 4);
+
+  // Scenario: every page reads back what was written, whichever thread wrote it to disk.
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, *reinterpret_cast<int *>(page->GetData()));
+    bpm->UnpinPage(i, false);
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FlushAllPagesTest) {
+  const std::string db_name = "bpm_flush_test.db";
+  const size_t buffer_pool_size = 64;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids(buffer_pool_size);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  auto dirty_all = [&](int round) {
+    for (auto page_id : page_ids) {
+      Page *page = bpm->FetchPage(page_id);
+      *reinterpret_cast<int *>(page->GetData()) = round;
+      *reinterpret_cast<page_id_t *>(page->GetData() + sizeof(int)) = page_id;
+      bpm->UnpinPage(page_id, true);
+    }
+  };
+
+  dirty_all(1);
+  EXPECT_EQ(buffer_pool_size, bpm->FlushAllPages());
+  // everything is clean now
+  EXPECT_EQ(0, bpm->FlushAllPages());
+
+  // Scenario: the pages written by the batch are read back after a restart, including a page dirtied afterwards.
+  dirty_all(2);
+  delete bpm;
+  delete disk_manager;
+  disk_manager = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    disk_manager->ReadPage(page_id, data);
+    ASSERT_EQ(2, *reinterpret_cast<int *>(data));
+    ASSERT_EQ(page_id, *reinterpret_cast<page_id_t *>(data + sizeof(int)));
+  }
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, StatsTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 4;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.pool_size_);
+  EXPECT_EQ(2 * buffer_pool_size, stats.new_pages_);
+  EXPECT_EQ(buffer_pool_size, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.foreground_writebacks_);
+  EXPECT_EQ(0, stats.disk_reads_);
+
+  // Pages 4..7 are resident, pages 0..3 were written back and must be read again.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(2 * buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(static_cast<page_id_t>(2 * buffer_pool_size) - 1 - i));
+    bpm->UnpinPage(static_cast<page_id_t>(2 * buffer_pool_size) - 1 - i, false);
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.hits_);
+  EXPECT_EQ(buffer_pool_size, stats.misses_);
+  EXPECT_EQ(buffer_pool_size, stats.disk_reads_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  // Every frame pinned: the next fetch has to give up and is counted as a pin wait.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(static_cast<page_id_t>(buffer_pool_size)));
+  EXPECT_EQ(1, bpm->GetStats().pin_waits_);
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    bpm->UnpinPage(i, false);
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 4;
+
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, replacer_type);
+
+    // Scenario: growing the pool gives room for more pinned pages right away.
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      Page *page = bpm->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      page_ids.push_back(page_id);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+    EXPECT_FALSE(bpm->Resize(0));
+    EXPECT_TRUE(bpm->Resize(2 * buffer_pool_size));
+    EXPECT_EQ(2 * buffer_pool_size, bpm->GetPoolSize());
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      Page *page = bpm->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      page_ids.push_back(page_id);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+
+    // Scenario: shrinking keeps the pinned frames until they are unpinned, and writes the dirty pages back.
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+    }
+    EXPECT_TRUE(bpm->Resize(buffer_pool_size / 2));
+    EXPECT_EQ(2 * buffer_pool_size, bpm->GetPoolSize());
+    for (size_t i = buffer_pool_size; i < page_ids.size(); i++) {
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+    }
+    EXPECT_EQ(buffer_pool_size / 2, bpm->GetPoolSize());
+    for (auto id : page_ids) {
+      Page *page = bpm->FetchPage(id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(id, false));
+    }
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+    EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[2]));
+    bpm->UnpinPage(page_ids[0], false);
+    bpm->UnpinPage(page_ids[1], false);
+
+    // Scenario: growing again reuses the trimmed frame ids.
+    EXPECT_TRUE(bpm->Resize(buffer_pool_size));
+    EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    }
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      bpm->UnpinPage(page_ids[i], false);
+    }
+    EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+    delete bpm;
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, WarmUpTest) {
+  const std::string db_name = "bpm_test.db";
+  const std::string warm_up_file = "bpm_test.db.warm";
+  const size_t buffer_pool_size = 64;
+  const size_t num_pages = 3 * buffer_pool_size;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  // touch every other page of the first two thirds, so the resident set is not a single run of ids
+  std::vector<page_id_t> hot_pages;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(2 * buffer_pool_size); i += 2) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+    hot_pages.push_back(i);
+  }
+  ASSERT_TRUE(bpm->DumpResidentPages(warm_up_file));
+  delete bpm;
+
+  // Scenario: after a restart the pool is refilled with the resident pages, most recently used first.
+  bpm = new BufferPoolManager(buffer_pool_size / 2, disk_manager);
+  bpm->WarmUp(warm_up_file);
+  bpm->WaitForWarmUp();
+  for (size_t i = hot_pages.size() - buffer_pool_size / 2; i < hot_pages.size(); i++) {
+    Page *page = bpm->FetchPage(hot_pages[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(hot_pages[i]), std::string(page->GetData()));
+    bpm->UnpinPage(hot_pages[i], false);
+  }
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size / 2, stats.hits_);
+  EXPECT_EQ(0, stats.misses_);
+  EXPECT_EQ(0, stats.evictions_);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(warm_up_file.c_str());
+}
+
+TEST(BufferPoolManagerTest, PrefetchRangeTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 64;
+  const size_t num_pages = 48;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  delete bpm;
+
+  // Scenario: fetches racing with an asynchronous range prefetch see every page exactly once from disk.
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->PrefetchRange(0, num_pages + 16);
+  for (page_id_t i = 0; i < static_cast<page_id_t>(num_pages); i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    bpm->UnpinPage(i, false);
+  }
+  EXPECT_EQ(num_pages, bpm->GetStats().disk_reads_);
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
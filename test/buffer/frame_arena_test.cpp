@@ -0,0 +1,48 @@
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(FrameArenaTest, GrowShrinkTest) {
+  for (bool huge_pages : {false, true}) {
+    FrameArena arena(huge_pages);
+    arena.Grow(100);
+    ASSERT_EQ(100, arena.GetSize());
+    // a single chunk, aligned for O_DIRECT, and to huge pages for the kernel to back it with them
+    const size_t alignment = huge_pages ? HUGE_PAGE_SIZE : PAGE_SIZE;
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrame(0)) % alignment);
+    for (size_t i = 0; i < arena.GetSize(); i++) {
+      ASSERT_EQ(arena.GetFrame(0) + i * PAGE_SIZE, arena.GetFrame(i));
+    }
+    // a huge page chunk holds more frames than asked for, the next Grow uses them first
+    const size_t capacity = arena.GetMappedBytes() / PAGE_SIZE;
+    ASSERT_EQ(huge_pages ? HUGE_PAGE_SIZE / PAGE_SIZE : 100, capacity);
+
+    // frames never move
+    char *frame_90 = arena.GetFrame(90);
+    arena.Grow(capacity - 100 + 50);
+    ASSERT_EQ(capacity + 50, arena.GetSize());
+    EXPECT_EQ(frame_90, arena.GetFrame(90));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrame(capacity)) % alignment);
+    for (size_t i = 0; i < arena.GetSize(); i++) {
+      arena.GetFrame(i)[PAGE_SIZE - 1] = 'x';
+    }
+
+    // the frames kept after a shrink are reused zeroed
+    arena.Shrink(capacity + 5);
+    ASSERT_EQ(capacity + 5, arena.GetSize());
+    arena.Grow(10);
+    EXPECT_EQ(frame_90, arena.GetFrame(90));
+    EXPECT_EQ('x', arena.GetFrame(capacity + 4)[PAGE_SIZE - 1]);
+    EXPECT_EQ(std::string(PAGE_SIZE, '\0'), std::string(arena.GetFrame(capacity + 5), PAGE_SIZE));
+    EXPECT_EQ(std::string(PAGE_SIZE, '\0'), std::string(arena.GetFrame(capacity + 14), PAGE_SIZE));
+
+    // the second chunk is released once none of its frames is kept
+    arena.Shrink(capacity);
+    EXPECT_EQ(capacity * PAGE_SIZE, arena.GetMappedBytes());
+    arena.Shrink(0);
+    EXPECT_EQ(0, arena.GetMappedBytes());
+  }
+}
@@ -0,0 +1,157 @@
+#include "buffer/lru_k_replacer.h"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+
+  // Scenario: reference frames 1-6 once, then frames 1 and 2 a second time.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    lru_k_replacer.Pin(i);
+    lru_k_replacer.Unpin(i);
+  }
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with a single reference have an infinite backward distance and go first, in LRU order.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+
+  // Scenario: pinned frames are not victims, removed frames are forgotten.
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Remove(6);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+
+  // Scenario: frame 5 now has two references, so every frame has a finite distance.
+  // Frame 1 has the oldest second most recent reference.
+  lru_k_replacer.Unpin(5);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(4, 2, 3);
+  auto reference = [&](frame_id_t frame_id) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  };
+
+  // Scenario: frame 2 gets two uncorrelated references at t=1 and t=5.
+  reference(2);
+  reference(1);
+  reference(1);
+  reference(1);
+  reference(2);
+  // Frame 1 is referenced four more times in a row (t=6..9), which is one correlated burst, then frame 3 at t=10.
+  for (int i = 0; i < 4; i++) {
+    reference(1);
+  }
+  reference(3);
+
+  // Frames 1 and 3 have a single reference each, but both are still inside their correlated period.
+  // Frame 2 is the only frame out of its period, so it is chosen although its backward distance is finite.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  // Every remaining frame is inside its period, fall back to the LRU-K order.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+}
+
+namespace {
+/**
+ * Replay a page reference trace against a replacer the way BufferPoolManager drives it and return the hit ratio.
+ */
+double ReplayTrace(Replacer *replacer, size_t pool_size, const std::vector<page_id_t> &trace) {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frames(pool_size, INVALID_PAGE_ID);
+  size_t next_free = 0;
+  size_t hits = 0;
+  for (auto page_id : trace) {
+    frame_id_t frame_id;
+    auto iter = page_table.find(page_id);
+    if (iter != page_table.end()) {
+      hits++;
+      frame_id = iter->second;
+    } else {
+      if (next_free < pool_size) {
+        frame_id = static_cast<frame_id_t>(next_free++);
+      } else {
+        EXPECT_TRUE(replacer->Victim(&frame_id));
+        page_table.erase(frames[frame_id]);
+      }
+      frames[frame_id] = page_id;
+      page_table[page_id] = frame_id;
+    }
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+}  // namespace
+
+/**
+ * Point lookups on a small B+ tree (root, internal and leaf pages) interleaved with repeated full scans of a heap much
+ * larger than the buffer pool. Every scanned page is fetched several times in a row, once per tuple.
+ */
+TEST(LRUKReplacerTest, MixedWorkloadHitRatioTest) {
+  const size_t pool_size = 256;
+  const page_id_t num_index_pages = 160;
+  const page_id_t num_heap_pages = 4096;
+  const int tuples_per_page = 4;
+  const int lookups_per_heap_page = 2;
+  const int num_scans = 3;
+
+  std::default_random_engine rng(0);
+  std::uniform_int_distribution<page_id_t> leaf_dist(2, num_index_pages - 1);
+  std::vector<page_id_t> trace;
+  auto point_lookup = [&]() {
+    trace.push_back(0);
+    trace.push_back(1);
+    trace.push_back(leaf_dist(rng));
+  };
+  // warm up the index before the first scan starts
+  for (int i = 0; i < 1000; i++) {
+    point_lookup();
+  }
+  for (int scan = 0; scan < num_scans; scan++) {
+    for (page_id_t page_id = num_index_pages; page_id < num_index_pages + num_heap_pages; page_id++) {
+      for (int i = 0; i < tuples_per_page; i++) {
+        trace.push_back(page_id);
+      }
+      for (int i = 0; i < lookups_per_heap_page; i++) {
+        point_lookup();
+      }
+    }
+  }
+
+  LRUReplacer lru(pool_size);
+  CLOCKReplacer clock(pool_size);
+  LRUKReplacer lru_k(pool_size);
+  double lru_hit_ratio = ReplayTrace(&lru, pool_size, trace);
+  double clock_hit_ratio = ReplayTrace(&clock, pool_size, trace);
+  double lru_k_hit_ratio = ReplayTrace(&lru_k, pool_size, trace);
+
+  EXPECT_GT(lru_k_hit_ratio, lru_hit_ratio);
+  EXPECT_GT(lru_k_hit_ratio, clock_hit_ratio);
+}
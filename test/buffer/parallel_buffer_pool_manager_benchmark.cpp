@@ -0,0 +1,84 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+/**
+ * Fetch and unpin random pages from a resident working set in every thread, returning the throughput in ops/s.
+ */
+double RunContention(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, size_t num_threads,
+                     size_t ops_per_thread) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::default_random_engine rng(t);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      for (size_t i = 0; i < ops_per_thread; i++) {
+        page_id_t page_id = page_ids[dist(rng)];
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        ASSERT_EQ(page_id, page->GetPageId());
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads * ops_per_thread) / elapsed.count();
+}
+
+std::vector<page_id_t> CreatePages(BufferPoolManager *bpm, size_t num_pages) {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+}  // namespace
+
+/**
+ * Contention benchmark: hot working set that fits in memory, fetched concurrently by 1/2/4/8 threads through a
+ * single BufferPoolManager and through a ParallelBufferPoolManager with the same total number of frames.
+ */
+TEST(ParallelBufferPoolManagerBenchmark, ContentionBenchmark) {
+  const std::string db_name = "pbpm_bench.db";
+  const size_t num_instances = 8;
+  const size_t pool_size = 1024;
+  const size_t num_pages = 512;
+  const size_t ops_per_thread = 100000;
+
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    double ops[2];
+    for (int parallel = 0; parallel < 2; parallel++) {
+      remove(db_name.c_str());
+      auto *disk_manager = new DiskManager(db_name);
+      BufferPoolManager *bpm;
+      if (parallel) {
+        bpm = new ParallelBufferPoolManager(num_instances, pool_size / num_instances, disk_manager);
+      } else {
+        bpm = new BufferPoolManager(pool_size, disk_manager);
+      }
+      auto page_ids = CreatePages(bpm, num_pages);
+      ops[parallel] = RunContention(bpm, page_ids, num_threads, ops_per_thread);
+      EXPECT_TRUE(bpm->CheckAllUnpinned());
+      delete bpm;
+      delete disk_manager;
+    }
+    std::printf("threads=%zu single=%.0f ops/s parallel(%zu)=%.0f ops/s\n", num_threads, ops[0], num_instances,
+                ops[1]);
+  }
+  remove(db_name.c_str());
+}
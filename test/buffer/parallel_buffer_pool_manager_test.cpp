@@ -0,0 +1,101 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(ParallelBufferPoolManagerTest, BinaryDataTest) {
+  const std::string db_name = "pbpm_test.db";
+  const size_t num_instances = 5;
+  const size_t buffer_pool_size = 10;
+
+  std::random_device r;
+  std::default_random_engine rng(r());
+  std::uniform_int_distribution<char> uniform_dist(0);
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  ASSERT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  char random_binary_data[PAGE_SIZE];
+  for (char &i : random_binary_data) {
+    i = uniform_dist(rng);
+  }
+  random_binary_data[PAGE_SIZE / 2] = '\0';
+  random_binary_data[PAGE_SIZE - 1] = '\0';
+  std::memcpy(page0->GetData(), random_binary_data, PAGE_SIZE);
+  EXPECT_EQ(0, std::memcmp(page0->GetData(), random_binary_data, PAGE_SIZE));
+
+  // Scenario: We should be able to create pages until every frame of every instance is pinned.
+  for (size_t i = 1; i < num_instances * buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_EQ(static_cast<page_id_t>(i), page_id_temp);
+  }
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+  }
+  // The page ids handed out on failure must have been given back to the disk manager.
+  EXPECT_TRUE(bpm->IsPageFree(static_cast<page_id_t>(num_instances * buffer_pool_size)));
+
+  // Scenario: Unpin the pages of the first instance. The next page id maps onto it, so creating a page evicts
+  // page 0 and writes it back to disk, while the page id after that maps onto a full instance again.
+  for (size_t i = 0; i < num_instances * buffer_pool_size; i += num_instances) {
+    EXPECT_TRUE(bpm->UnpinPage(static_cast<page_id_t>(i), true));
+  }
+  EXPECT_NE(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_EQ(static_cast<page_id_t>(num_instances * buffer_pool_size), page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id_temp));
+
+  // Scenario: We should be able to fetch the data we wrote a while ago.
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, memcmp(page0->GetData(), random_binary_data, PAGE_SIZE));
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  EXPECT_FALSE(bpm->UnpinPage(0, true));
+
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    if (i % num_instances != 0) {
+      bpm->UnpinPage(static_cast<page_id_t>(i), false);
+    }
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "pbpm_test.db";
+  const size_t num_instances = 4;
+  const size_t pool_size = 2;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+  EXPECT_EQ(num_instances * pool_size, bpm->GetPoolSize());
+
+  EXPECT_FALSE(bpm->Resize(num_instances - 1));
+  EXPECT_TRUE(bpm->Resize(4 * num_instances + 1));
+  EXPECT_EQ(4 * num_instances + 1, bpm->GetPoolSize());
+  EXPECT_EQ(5, bpm->GetBufferPoolManager(0)->GetPoolSize());
+  EXPECT_EQ(4, bpm->GetBufferPoolManager(1)->GetPoolSize());
+  EXPECT_TRUE(bpm->Resize(num_instances));
+  EXPECT_EQ(num_instances, bpm->GetPoolSize());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,101 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/comparator.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+namespace {
+const std::string db_name = "read_ahead_benchmark.db";
+const size_t cold_pool_size = 256;
+
+/**
+ * Write back and evict the database file from the OS page cache, so that the next scan really reads from disk. The
+ * resident page list is dropped too, so that the buffer pool is not warmed up on open.
+ */
+void DropFileCache() {
+  remove(("./databases/." + db_name + ".warm").c_str());
+  int fd = open(("./databases/" + db_name).c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+/**
+ * Benchmark: cold full scans of a table heap and cold range scans over the leaves of a B+ tree, with and without
+ * read-ahead. Every run starts from a freshly opened database with an empty buffer pool and a dropped file cache.
+ */
+TEST(ReadAheadBenchmark, ColdScanBenchmark) {
+  const int row_nums = 40000;
+  const int key_nums = 50000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  std::vector<Column *> key_columns = {new Column("int", TypeId::kTypeInt, 0, false, false)};
+  Schema key_schema(key_columns);
+  KeyManager KP(&key_schema, 16);
+
+  page_id_t first_page_id;
+  {
+    DBStorageEngine engine(db_name);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+    first_page_id = table_heap->GetFirstPageId();
+    char name[64];
+    memset(name, 'x', sizeof(name));
+    for (int i = 0; i < row_nums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    delete table_heap;
+    BPlusTree tree(0, engine.bpm_, KP);
+    GenericKey *key = KP.InitKey();
+    for (int i = 0; i < key_nums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+      KP.SerializeFromKey(key, Row(fields), &key_schema);
+      ASSERT_TRUE(tree.Insert(key, RowId(i), nullptr));
+    }
+  }
+
+  for (size_t window : {static_cast<size_t>(0), static_cast<size_t>(DEFAULT_READ_AHEAD_WINDOW)}) {
+    DropFileCache();
+    DBStorageEngine engine(db_name, false, cold_pool_size);
+    engine.bpm_->SetReadAheadWindow(window);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, first_page_id, &schema, nullptr, nullptr);
+    auto start = std::chrono::steady_clock::now();
+    int rows = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+      rows++;
+    }
+    double scan_ms = ElapsedMs(start);
+    EXPECT_EQ(row_nums, rows);
+    delete table_heap;
+
+    BPlusTree tree(0, engine.bpm_, KP);
+    start = std::chrono::steady_clock::now();
+    int keys = 0;
+    auto iter = tree.Begin();
+    for (; keys < key_nums; ++iter) {
+      ASSERT_EQ(RowId(keys), (*iter).second);
+      keys++;
+    }
+    double range_ms = ElapsedMs(start);
+    std::printf("read-ahead window=%zu: cold table scan %.2f ms, cold index range scan %.2f ms\n", window, scan_ms,
+                range_ms);
+  }
+}
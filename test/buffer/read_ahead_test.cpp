@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "page/table_page.h"
+
+namespace {
+/** Runs the read-ahead of the I/O worker on the calling thread */
+class ReadAheadBufferPoolManager : public BufferPoolManager {
+ public:
+  using BufferPoolManager::BufferPoolManager;
+  using BufferPoolManager::ReadAhead;
+};
+}  // namespace
+
+TEST(ReadAheadTest, FreedChainPageTest) {
+  const std::string db_file_name = "read_ahead_freed_test.db";
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new ReadAheadBufferPoolManager(4, disk_mgr);
+  page_id_t first_page_id, freed_page_id;
+  Page *first_page = bpm->NewPage(first_page_id);
+  ASSERT_NE(nullptr, bpm->NewPage(freed_page_id));
+  *reinterpret_cast<page_id_t *>(first_page->GetData() + TablePage::OFFSET_NEXT_PAGE_ID) = freed_page_id;
+  ASSERT_TRUE(bpm->UnpinPage(first_page_id, true));
+  ASSERT_TRUE(bpm->UnpinPage(freed_page_id, false));
+  // the first page still links to a page freed since, the chain read-ahead must not load the freed page
+  ASSERT_TRUE(bpm->DeletePage(freed_page_id));
+  ASSERT_EQ(freed_page_id, bpm->ReadAhead(first_page_id, TablePage::OFFSET_NEXT_PAGE_ID));
+  uint64_t disk_reads = bpm->GetStats().disk_reads_;
+  EXPECT_EQ(INVALID_PAGE_ID, bpm->ReadAhead(freed_page_id, TablePage::OFFSET_NEXT_PAGE_ID));
+  EXPECT_EQ(disk_reads, bpm->GetStats().disk_reads_);
+
+  // the id handed out again maps to a single frame, its data survives the eviction of every other page
+  page_id_t page_id;
+  Page *page = bpm->NewPage(page_id);
+  ASSERT_EQ(freed_page_id, page_id);
+  snprintf(page->GetData(), PAGE_SIZE, "reused");
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  for (int i = 0; i < 8; i++) {
+    page_id_t other_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(other_page_id));
+    ASSERT_TRUE(bpm->UnpinPage(other_page_id, false));
+  }
+  page = bpm->FetchPage(freed_page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("reused", page->GetData());
+  ASSERT_TRUE(bpm->UnpinPage(freed_page_id, false));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
@@ -125,4 +125,210 @@ TEST(CatalogTest, CatalogIndexTest) {
      ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CompactPagesTest) {
+  const int row_nums = 3000;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  // the first table takes the low pages and is dropped, the second one and its index move down into them
+  for (const std::string table_name : {"table-1", "table-2"}) {
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable(table_name, schema.get(), &txn, table_info));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex(table_name, table_name + "-id", {"id"}, &txn, index_info, "bptree"));
+    for (int i = 0; i < row_nums; i++) {
+      std::string name = table_name + "-" + std::to_string(i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                                Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(Row(key_fields), row.GetRowId(), &txn));
+    }
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->DropTable("table-1"));
+  db_01->bpm_->FlushAllPages();
+  const page_id_t last_page_id = db_01->bpm_->GetLastAllocatedPageId();
+
+  // the first step collects the live pages and frees the unreachable ones, the next steps go on from there
+  auto page_fetches = [&]() {
+    BufferPoolStats stats = db_01->bpm_->GetStats();
+    return stats.hits_ + stats.misses_;
+  };
+  size_t moved_pages = 0;
+  size_t freed_pages = 0;
+  size_t step_moved_pages;
+  size_t step_freed_pages;
+  uint64_t fetches = page_fetches();
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CompactPages(0, &step_moved_pages, &step_freed_pages));
+  const uint64_t collect_fetches = page_fetches() - fetches;
+  EXPECT_EQ(0, step_moved_pages);
+  EXPECT_GT(step_freed_pages, 0);
+  freed_pages += step_freed_pages;
+  fetches = page_fetches();
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CompactPages(0, &step_moved_pages, &step_freed_pages));
+  EXPECT_LT(page_fetches() - fetches, collect_fetches / 10);
+  EXPECT_EQ(0, step_freed_pages);
+
+  // small steps, as a throttled compaction would take, with a statement allocating pages between two of them
+  const size_t step_pages = 16;
+  size_t steps = 0;
+  uint64_t other_new_pages = 0;
+  do {
+    if (steps == 2) {
+      uint64_t new_pages = db_01->bpm_->GetStats().new_pages_;
+      TableInfo *table_info = nullptr;
+      ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-3", schema.get(), &txn, table_info));
+      other_new_pages = db_01->bpm_->GetStats().new_pages_ - new_pages;
+    }
+    ASSERT_EQ(DB_SUCCESS, catalog_01->CompactPages(step_pages, &step_moved_pages, &step_freed_pages));
+    moved_pages += step_moved_pages;
+    freed_pages += step_freed_pages;
+    steps++;
+  } while (step_moved_pages == step_pages);
+  EXPECT_GT(steps, 2);
+  EXPECT_GT(freed_pages, 0);
+  EXPECT_GT(moved_pages, 0);
+  // the live pages are packed at the front of the file
+  const page_id_t compacted_last_page_id = db_01->bpm_->GetLastAllocatedPageId();
+  EXPECT_LE(compacted_last_page_id,
+            last_page_id - static_cast<page_id_t>(freed_pages) + static_cast<page_id_t>(other_new_pages));
+  for (page_id_t page_id = 0; page_id <= compacted_last_page_id; page_id++) {
+    ASSERT_FALSE(db_01->bpm_->IsPageFree(page_id));
+  }
+  db_01->bpm_->FlushAllPages();
+  EXPECT_GT(db_01->disk_mgr_->TruncateFile(), freed_pages * PAGE_SIZE / 2);
+  delete db_01;
+
+  // every row is found through the heap and through the index, also after a restart
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  auto &catalog_02 = db_02->catalog_mgr_;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_02->GetTable("table-1", table_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-3", table_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-2", table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-2", "table-2-id", index_info));
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); ++iter) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, count)};
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(key_fields[0]));
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), result, &txn));
+    ASSERT_EQ(iter->GetRowId().Get(), result[0].Get());
+    count++;
+  }
+  EXPECT_EQ(row_nums, count);
+  delete db_02;
+}
+
+/**
+ * Write table metadata as it was written before the free space map page id was stored.
+ * @return the size of the metadata
+ */
+static uint32_t SerializeLegacyTableMetadata(table_id_t table_id, const std::string &table_name,
+                                             page_id_t first_page_id, Schema *schema, char *buf) {
+  char *p = buf;
+  MACH_WRITE_UINT32(p, 344528);
+  p += 4;
+  MACH_WRITE_TO(table_id_t, p, table_id);
+  p += 4;
+  MACH_WRITE_UINT32(p, table_name.length());
+  p += 4;
+  MACH_WRITE_STRING(p, table_name);
+  p += table_name.length();
+  MACH_WRITE_TO(page_id_t, p, first_page_id);
+  p += 4;
+  p += schema->SerializeTo(p);
+  return p - buf;
+}
+
+TEST(CatalogTest, TableMetadataLegacyFormatTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  char buf[PAGE_SIZE];
+  std::string table_name = "table-legacy";
+  uint32_t legacy_size = SerializeLegacyTableMetadata(3, table_name, 17, &schema, buf);
+  TableMetadata *table_meta = nullptr;
+  ASSERT_EQ(legacy_size, TableMetadata::DeserializeFrom(buf, table_meta));
+  EXPECT_EQ(3, table_meta->GetTableId());
+  EXPECT_EQ(table_name, table_meta->GetTableName());
+  EXPECT_EQ(17, table_meta->GetFirstPageId());
+  EXPECT_EQ(INVALID_PAGE_ID, table_meta->GetFreeSpaceMapPageId());
+  ASSERT_EQ(2, table_meta->GetSchema()->GetColumnCount());
+  EXPECT_EQ("name", table_meta->GetSchema()->GetColumn(1)->GetName());
+  // written back in the current format, with the page id of its free space map
+  table_meta->SetFreeSpaceMapPageId(21);
+  char new_buf[PAGE_SIZE];
+  uint32_t size = table_meta->SerializeTo(new_buf);
+  TableMetadata *new_table_meta = nullptr;
+  ASSERT_EQ(size, TableMetadata::DeserializeFrom(new_buf, new_table_meta));
+  EXPECT_EQ(17, new_table_meta->GetFirstPageId());
+  EXPECT_EQ(21, new_table_meta->GetFreeSpaceMapPageId());
+  delete table_meta;
+  delete new_table_meta;
+}
+
+TEST(CatalogTest, LegacyTableReopenTest) {
+  const int row_nums = 500;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-legacy", schema.get(), &txn, table_info));
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  // turn the table into one written before the free space map was kept: no map pages, metadata in the old format
+  std::vector<page_id_t> fsm_page_ids;
+  table_info->GetTableHeap()->GetFreeSpaceMapPageIds(&fsm_page_ids);
+  for (auto page_id : fsm_page_ids) {
+    ASSERT_TRUE(db_01->bpm_->DeletePage(page_id));
+  }
+  Page *catalog_meta_page = db_01->bpm_->FetchPage(CATALOG_META_PAGE_ID);
+  CatalogMeta *catalog_meta = CatalogMeta::DeserializeFrom(catalog_meta_page->GetData());
+  db_01->bpm_->UnpinPage(CATALOG_META_PAGE_ID, false);
+  page_id_t meta_page_id = catalog_meta->GetTableMetaPages()->at(table_info->GetTableId());
+  delete catalog_meta;
+  Page *meta_page = db_01->bpm_->FetchPage(meta_page_id);
+  SerializeLegacyTableMetadata(table_info->GetTableId(), "table-legacy", table_info->GetRootPageId(), schema.get(),
+                               meta_page->GetData());
+  db_01->bpm_->UnpinPage(meta_page_id, true);
+  delete db_01;
+
+  // the first open builds the map and records it in the metadata, the next one reads it without allocating a page
+  page_id_t fsm_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  for (int open = 0; open < 2; open++) {
+    auto db = new DBStorageEngine(db_file_name, false);
+    ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->GetTable("table-legacy", table_info));
+    page_id_t meta_fsm_page_id = table_info->GetTableMeta()->GetFreeSpaceMapPageId();
+    ASSERT_NE(INVALID_PAGE_ID, meta_fsm_page_id);
+    EXPECT_EQ(meta_fsm_page_id, table_info->GetTableHeap()->GetFreeSpaceMapPageId());
+    if (open == 0) {
+      fsm_page_id = meta_fsm_page_id;
+      last_page_id = db->bpm_->GetLastAllocatedPageId();
+    } else {
+      EXPECT_EQ(fsm_page_id, meta_fsm_page_id);
+      EXPECT_EQ(last_page_id, db->bpm_->GetLastAllocatedPageId());
+      EXPECT_EQ(0, db->bpm_->GetStats().new_pages_);
+    }
+    int count = 0;
+    for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); ++iter) {
+      count++;
+    }
+    EXPECT_EQ(row_nums, count);
+    delete db;
+  }
+}
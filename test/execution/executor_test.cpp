@@ -1,6 +1,9 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include <set>
+#include <string>
+
 #include "executor/plans/delete_plan.h"
 #include "executor/plans/insert_plan.h"
 #include "executor/plans/seq_scan_plan.h"
@@ -155,3 +158,85 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// INSERT INTO table-1 VALUES (2000, "bulk", 1.5), (2001, "bulk", 1.5), ...; with a duplicate key part way
+TEST_F(ExecutorTest, BulkInsertTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info;
+  ASSERT_EQ(DB_SUCCESS,
+            GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "id-index", {"id"}, GetTxn(), index_info, "bptree"));
+  // index the rows in the table, so that the insert adds its entries to a populated tree
+  std::vector<std::pair<Row, RowId>> entries;
+  for (auto iter = table_info->GetTableHeap()->Begin(GetTxn()); iter != table_info->GetTableHeap()->End(); ++iter) {
+    Row key;
+    iter->GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key);
+    entries.emplace_back(key, iter->GetRowId());
+  }
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->BulkLoad(entries, GetTxn()));
+  // enough rows for the bulk path, the rows from the duplicate of 2100 on are not inserted
+  const int row_nums = 4 * DEFAULT_BULK_INSERT_MIN_ROWS;
+  const int duplicate_at = 3 * DEFAULT_BULK_INSERT_MIN_ROWS;
+  std::vector<std::vector<AbstractExpressionRef>> raw_values;
+  for (int i = 0; i < row_nums; i++) {
+    int id = i == duplicate_at ? 2100 : 2000 + i;
+    raw_values.push_back({MakeConstantValueExpression(Field(kTypeInt, id)),
+                          MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>("bulk"), 4, false)),
+                          MakeConstantValueExpression(Field(kTypeFloat, static_cast<float>(1.5)))});
+  }
+  auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, raw_values);
+  auto insert_plan = std::make_shared<InsertPlanNode>(nullptr, value_plan, "table-1");
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(insert_plan, &result_set, GetTxn(), GetExecutorContext());
+
+  // the heap holds the rows before the duplicate, and the index finds each of them
+  std::set<int> ids;
+  for (auto iter = table_info->GetTableHeap()->Begin(GetTxn()); iter != table_info->GetTableHeap()->End(); ++iter) {
+    int id = std::stoi(iter->GetField(0)->toString());
+    ASSERT_TRUE(ids.insert(id).second);
+    std::vector<Field> key_fields{Field(kTypeInt, id)};
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), rids, GetTxn()));
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(iter->GetRowId().Get(), rids[0].Get());
+  }
+  ASSERT_EQ(1000 + duplicate_at, ids.size());
+  EXPECT_EQ(2000 + duplicate_at - 1, *ids.rbegin());
+  std::vector<Field> key_fields{Field(kTypeInt, 2000 + duplicate_at)};
+  std::vector<RowId> rids;
+  index_info->GetIndex()->ScanKey(Row(key_fields), rids, GetTxn());
+  ASSERT_TRUE(rids.empty());
+}
+
+// INSERT INTO table-1 VALUES (3000, "bulk", 1.5), ...; with a row too large for a page part way
+TEST_F(ExecutorTest, BulkInsertOversizedRowTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  // like the row-at-a-time path, the oversized row is skipped and the rows around it are inserted
+  const int row_nums = 2 * DEFAULT_BULK_INSERT_MIN_ROWS;
+  const int oversized_at = DEFAULT_BULK_INSERT_MIN_ROWS / 2;
+  std::string large_name(PAGE_SIZE, 'x');
+  std::vector<std::vector<AbstractExpressionRef>> raw_values;
+  for (int i = 0; i < row_nums; i++) {
+    Field name = i == oversized_at ? Field(kTypeChar, large_name.data(), large_name.size(), false)
+                                   : Field(kTypeChar, const_cast<char *>("bulk"), 4, false);
+    raw_values.push_back({MakeConstantValueExpression(Field(kTypeInt, 3000 + i)), MakeConstantValueExpression(name),
+                          MakeConstantValueExpression(Field(kTypeFloat, static_cast<float>(1.5)))});
+  }
+  auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, raw_values);
+  auto insert_plan = std::make_shared<InsertPlanNode>(nullptr, value_plan, "table-1");
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(insert_plan, &result_set, GetTxn(), GetExecutorContext());
+
+  std::set<int> ids;
+  for (auto iter = table_info->GetTableHeap()->Begin(GetTxn()); iter != table_info->GetTableHeap()->End(); ++iter) {
+    int id = std::stoi(iter->GetField(0)->toString());
+    if (id >= 3000) {
+      ASSERT_TRUE(ids.insert(id).second);
+    }
+  }
+  ASSERT_EQ(row_nums - 1, ids.size());
+  EXPECT_EQ(0, ids.count(3000 + oversized_at));
+  EXPECT_EQ(1, ids.count(3000 + oversized_at - 1));
+  EXPECT_EQ(1, ids.count(3000 + row_nums - 1));
+}
@@ -3,6 +3,7 @@
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/comparator.h"
+#include "page/index_roots_page.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -71,4 +72,76 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  BPlusTree tree(0, engine.bpm_, KP);
+  const int n = 10000;
+  vector<GenericKey *> keys;
+  vector<std::pair<GenericKey *, RowId>> entries;
+  // even keys only, the odd ones are inserted after the load
+  for (int i = 0; i < 2 * n; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    keys.push_back(key);
+    if (i % 2 == 0) {
+      entries.emplace_back(key, RowId(i));
+    }
+  }
+  ASSERT_TRUE(tree.BulkLoad(entries));
+  ASSERT_FALSE(tree.BulkLoad(entries));
+  ASSERT_TRUE(tree.Check());
+  // Scenario: the leaves are linked in key order and lie next to each other in the file.
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t root_page_id;
+  ASSERT_TRUE(roots_page->GetRootId(0, &root_page_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  auto leaf = reinterpret_cast<LeafPage *>(tree.FindLeafPage(nullptr, root_page_id, true)->GetData());
+  int leaves = 1;
+  int key_count = leaf->GetSize();
+  // the last leaf has next page id 0
+  while (leaf->GetNextPageId() != 0) {
+    page_id_t page_id = leaf->GetPageId();
+    EXPECT_EQ(page_id + 1, leaf->GetNextPageId());
+    leaf = reinterpret_cast<LeafPage *>(engine.bpm_->FetchPage(leaf->GetNextPageId())->GetData());
+    engine.bpm_->UnpinPage(page_id, false);
+    EXPECT_GE(leaf->GetSize(), leaf->GetMinSize());
+    key_count += leaf->GetSize();
+    leaves++;
+  }
+  engine.bpm_->UnpinPage(leaf->GetPageId(), false);
+  EXPECT_EQ(n, key_count);
+  EXPECT_GT(leaves, 1);
+  // Scenario: the loaded tree supports lookups, inserts, removals and range scans as usual.
+  vector<RowId> ans;
+  for (int i = 0; i < 2 * n; i += 2) {
+    ans.clear();
+    ASSERT_TRUE(tree.GetValue(keys[i], ans));
+    ASSERT_EQ(RowId(i), ans[0]);
+  }
+  for (int i = 1; i < 2 * n; i += 2) {
+    ASSERT_TRUE(tree.Insert(keys[i], RowId(i)));
+  }
+  for (int i = 0; i < 2 * n; i += 4) {
+    tree.Remove(keys[i]);
+  }
+  ASSERT_TRUE(tree.Check());
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    if (expected % 4 == 0) {
+      expected++;
+    }
+    ASSERT_EQ(RowId(expected), (*iter).second);
+    expected++;
+  }
+  EXPECT_EQ(2 * n, expected);
+  for (auto key : keys) {
+    free(key);
+  }
+}
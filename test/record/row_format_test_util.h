@@ -0,0 +1,33 @@
+#ifndef MINISQL_ROW_FORMAT_TEST_UTIL_H
+#define MINISQL_ROW_FORMAT_TEST_UTIL_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "record/field.h"
+
+/**
+ * Write a row in the sequential format of version 0, as rows were stored before the fixed-offset format.
+ */
+inline uint32_t SerializeSequential(const std::vector<Field> &fields, char *buf) {
+  uint32_t ofs = 0;
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(fields.size()));
+  ofs += sizeof(uint32_t);
+  memset(buf + ofs, 0, (fields.size() + 7) / 8);
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (!fields[i].IsNull()) {
+      buf[ofs + i / 8] |= static_cast<char>(0x80 >> (i % 8));
+    }
+  }
+  ofs += (fields.size() + 7) / 8;
+  for (auto &field : fields) {
+    if (!field.IsNull()) {
+      ofs += field.SerializeTo(buf + ofs);
+    }
+  }
+  return ofs;
+}
+
+#endif  // MINISQL_ROW_FORMAT_TEST_UTIL_H
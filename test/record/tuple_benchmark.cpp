@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+#include "row_format_test_util.h"  // NOLINT
+
+/**
+ * Benchmark: cost of reading one column of a wide row, in the sequential and the fixed-offset formats.
+ */
+TEST(TupleBenchmark, RowFormatAccessBenchmark) {
+  const uint32_t column_num = 64;
+  const int iterations = 200000;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  char name[] = "minisql";
+  for (uint32_t i = 0; i < column_num; i++) {
+    if (i % 4 == 3) {
+      columns.push_back(new Column("c" + std::to_string(i), TypeId::kTypeChar, 16, i, true, false));
+      fields.emplace_back(TypeId::kTypeChar, name, strlen(name), false);
+    } else if (i % 4 == 2) {
+      columns.push_back(new Column("c" + std::to_string(i), TypeId::kTypeFloat, i, true, false));
+      fields.emplace_back(TypeId::kTypeFloat, 1.5f * i);
+    } else {
+      columns.push_back(new Column("c" + std::to_string(i), TypeId::kTypeInt, i, true, false));
+      fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i));
+    }
+  }
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char fixed_offset[PAGE_SIZE];
+  char sequential[PAGE_SIZE];
+  row.SerializeTo(fixed_offset, schema.get());
+  SerializeSequential(fields, sequential);
+  for (uint32_t column : {0u, column_num / 2, column_num - 1}) {
+    for (char *data : {sequential, fixed_offset}) {
+      int matched = 0;
+      RowView view;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++) {
+        view.Reset(data, schema.get());
+        matched += view.GetField(column).CompareEquals(fields[column]) == CmpBool::kTrue;
+      }
+      double view_ns =
+          std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+      start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations / 10; i++) {
+        Row read_row;
+        read_row.DeserializeFrom(data, schema.get());
+        matched += read_row.GetField(column)->CompareEquals(fields[column]) == CmpBool::kTrue;
+      }
+      double row_ns =
+          std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (iterations / 10);
+      ASSERT_EQ(iterations + iterations / 10, matched);
+      std::printf("%-12s column %2u of %u: RowView %.1f ns, Row::DeserializeFrom %.1f ns\n",
+                  data == sequential ? "sequential" : "fixed-offset", column, column_num, view_ns, row_ns);
+    }
+  }
+}
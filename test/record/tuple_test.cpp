@@ -3,9 +3,15 @@
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
+#include "row_format_test_util.h"  // NOLINT
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
                  const_cast<char *>("\0")};
@@ -100,4 +106,130 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeChar),
+                               Field(TypeId::kTypeFloat, 19.99f),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)};
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+  RowView view(buffer, schema.get(), RowId(1, 2));
+  ASSERT_EQ(4, view.GetFieldCount());
+  EXPECT_EQ(RowId(1, 2), view.GetRowId());
+  EXPECT_TRUE(view.IsNull(1));
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    Field field = view.GetField(i);
+    ASSERT_EQ(fields[i].IsNull(), field.IsNull());
+    if (!field.IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+    }
+  }
+  // a CHAR field points into the serialized row
+  Field note = view.GetField(3);
+  EXPECT_LT(buffer, note.GetData());
+  EXPECT_GT(buffer + PAGE_SIZE, note.GetData());
+  Row materialized;
+  view.Materialize(&materialized);
+  ASSERT_EQ(4, materialized.GetFieldCount());
+  EXPECT_EQ(RowId(1, 2), materialized.GetRowId());
+  EXPECT_EQ(CmpBool::kTrue, materialized.GetField(3)->CompareEquals(fields[3]));
+
+  // expressions evaluate the same against the row and its view
+  auto id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+  auto note_column = std::make_shared<ColumnValueExpression>(0, 3, TypeId::kTypeChar);
+  auto id_match = std::make_shared<ComparisonExpression>(
+      id, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 100)), ">");
+  auto note_match = std::make_shared<ComparisonExpression>(
+      note_column,
+      std::make_shared<ConstantValueExpression>(
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)),
+      "=");
+  auto name_null = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar),
+      std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeChar)), "is");
+  LogicExpression both(id_match, note_match, LogicType::And);
+  for (const AbstractExpression *expr : {static_cast<const AbstractExpression *>(id_match.get()),
+                                         static_cast<const AbstractExpression *>(note_match.get()),
+                                         static_cast<const AbstractExpression *>(name_null.get()),
+                                         static_cast<const AbstractExpression *>(&both)}) {
+    Field expected = expr->Evaluate(&row);
+    Field actual = expr->Evaluate(view);
+    ASSERT_EQ(CmpBool::kTrue, expected.CompareEquals(Field(TypeId::kTypeInt, 1)));
+    ASSERT_EQ(CmpBool::kTrue, actual.CompareEquals(expected));
+  }
+
+  // only the tuples a filter accepts are decoded from a page
+  TablePage table_page;
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> page_fields = {Field(TypeId::kTypeInt, i * 50), Field(TypeId::kTypeChar),
+                                      Field(TypeId::kTypeFloat, 19.99f),
+                                      Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)};
+    Row page_row(page_fields);
+    ASSERT_TRUE(table_page.InsertTuple(page_row, schema.get(), nullptr, nullptr, nullptr));
+  }
+  std::vector<Row> rows;
+  size_t count = table_page.GetTuples(&rows, schema.get(), [&](const RowView &tuple) {
+    return id_match->Evaluate(tuple).CompareEquals(Field(TypeId::kTypeInt, 1)) == CmpBool::kTrue;
+  });
+  ASSERT_EQ(7, count);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(RowId(0, i + 3), rows[i].GetRowId());
+    EXPECT_EQ(CmpBool::kTrue, rows[i].GetField(0)->CompareEquals(Field(TypeId::kTypeInt, static_cast<int32_t>(i + 3) * 50)));
+  }
+}
+
+TEST(TupleTest, RowFormatTest) {
+  std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 64, 0, true, false),
+                                   new Column("id", TypeId::kTypeInt, 1, false, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 2, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 3, true, false),
+                                   new Column("tag", TypeId::kTypeChar, 16, 4, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // fixed-width columns first, then the offset table of the CHAR columns
+  EXPECT_EQ(5, schema->GetFieldOffset(1));
+  EXPECT_EQ(9, schema->GetFieldOffset(3));
+  EXPECT_EQ(13, schema->GetCharOffsetTableOffset());
+  EXPECT_EQ(13, schema->GetFieldOffset(0));
+  EXPECT_EQ(17, schema->GetFieldOffset(2));
+  EXPECT_EQ(21, schema->GetFieldOffset(4));
+  EXPECT_EQ(25, schema->GetRowFixedSize());
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false), Field(TypeId::kTypeInt, 7),
+       Field(TypeId::kTypeChar, const_cast<char *>(""), 0, false), Field(TypeId::kTypeFloat, 19.99f),
+       Field(TypeId::kTypeChar, const_cast<char *>("tag"), strlen("tag"), false)},
+      {Field(TypeId::kTypeChar), Field(TypeId::kTypeInt), Field(TypeId::kTypeChar, const_cast<char *>("x"), 1, false),
+       Field(TypeId::kTypeFloat), Field(TypeId::kTypeChar)}};
+  for (auto &fields : rows) {
+    Row row(fields);
+    char buffer[PAGE_SIZE];
+    uint32_t size = row.SerializeTo(buffer, schema.get());
+    ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+    ASSERT_EQ(Row::FORMAT_VERSION, MACH_READ_UINT32(buffer) >> 24);
+    // rows written in the sequential format of version 0 still read
+    char legacy[PAGE_SIZE];
+    uint32_t legacy_size = SerializeSequential(fields, legacy);
+    for (char *data : {buffer, legacy}) {
+      Row read_row;
+      ASSERT_EQ(data == buffer ? size : legacy_size, read_row.DeserializeFrom(data, schema.get()));
+      RowView view(data, schema.get());
+      ASSERT_EQ(fields.size(), read_row.GetFieldCount());
+      ASSERT_EQ(fields.size(), view.GetFieldCount());
+      for (uint32_t i = 0; i < fields.size(); i++) {
+        Field field = view.GetField(i);
+        ASSERT_EQ(fields[i].IsNull(), read_row.GetField(i)->IsNull());
+        ASSERT_EQ(fields[i].IsNull(), field.IsNull());
+        if (!fields[i].IsNull()) {
+          ASSERT_EQ(CmpBool::kTrue, read_row.GetField(i)->CompareEquals(fields[i]));
+          ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+        }
+      }
+    }
+  }
+}
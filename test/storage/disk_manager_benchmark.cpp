@@ -0,0 +1,150 @@
+#include "storage/disk_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+/**
+ * Benchmark: random page reads from several threads with the stream backend, which serializes every access, and the
+ * positional backend, which does not. The file is small enough to stay in the OS page cache, so the difference comes
+ * from the latch rather than from the device.
+ */
+TEST(DiskManagerBenchmark, ConcurrentRandomReadBenchmark) {
+  std::string db_name = "disk_benchmark.db";
+  const page_id_t num_pages = 4096;
+  const size_t num_threads = 4;
+  const size_t reads_per_thread = 50000;
+
+  remove(db_name.c_str());
+  {
+    DiskManager disk_mgr(db_name);
+    char data[PAGE_SIZE];
+    for (page_id_t i = 0; i < num_pages; i++) {
+      memset(data, 0, PAGE_SIZE);
+      *reinterpret_cast<page_id_t *>(data) = i;
+      disk_mgr.WritePage(i, data);
+    }
+  }
+  for (auto backend : {DiskIOBackend::FSTREAM, DiskIOBackend::POSITIONAL}) {
+    DiskManager disk_mgr(db_name, backend);
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        std::mt19937 rng(t);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        char data[PAGE_SIZE];
+        for (size_t i = 0; i < reads_per_thread; i++) {
+          page_id_t page_id = dist(rng);
+          disk_mgr.ReadPage(page_id, data);
+          if (*reinterpret_cast<page_id_t *>(data) != page_id) {
+            mismatches++;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(0, mismatches);
+    std::printf("%s backend: %zu threads x %zu random reads in %.2f ms\n",
+                backend == DiskIOBackend::FSTREAM ? "fstream" : "pread", num_threads, reads_per_thread, elapsed_ms);
+  }
+  remove(db_name.c_str());
+}
+
+/**
+ * Benchmark: allocate two full extents, then free every other page and allocate them again.
+ */
+TEST(DiskManagerBenchmark, AllocatePageBenchmark) {
+  std::string db_name = "disk_benchmark.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint32_t num_pages = 2 * DiskManager::BITMAP_SIZE;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  for (uint32_t i = 0; i < num_pages; i += 2) {
+    disk_mgr->DeAllocatePage(i);
+  }
+  for (uint32_t i = 0; i < num_pages; i += 2) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->Close();
+  double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%u allocations and %u deallocations in %.2f ms\n", num_pages * 3 / 2, num_pages / 2, elapsed_ms);
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * Benchmark: random point lookups and a full scan of a read-only database bigger than the buffer pool, through the
+ * buffer pool with pread, through the buffer pool copying from the mapping, and in place through the mapping. The file
+ * stays in the OS page cache, so the difference is the copying and bookkeeping rather than the device.
+ */
+TEST(DiskManagerBenchmark, MmapLookupBenchmark) {
+  std::string db_name = "disk_benchmark.db";
+  const page_id_t num_pages = 16384;
+  const size_t buffer_pool_size = 1024;
+  const size_t num_lookups = 200000;
+  remove(db_name.c_str());
+  {
+    DiskManager disk_mgr(db_name);
+    char data[PAGE_SIZE];
+    for (page_id_t i = 0; i < num_pages; i++) {
+      disk_mgr.AllocatePage();
+      memset(data, 0, PAGE_SIZE);
+      *reinterpret_cast<page_id_t *>(data) = i;
+      disk_mgr.WritePage(i, data);
+    }
+  }
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+  std::vector<page_id_t> lookups(num_lookups);
+  for (auto &page_id : lookups) {
+    page_id = dist(rng);
+  }
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  for (int mode = 0; mode < 3; mode++) {
+    DiskManager disk_mgr(db_name, mode == 0 ? DiskIOBackend::POSITIONAL : DiskIOBackend::MMAP);
+    auto *bpm = mode == 2 ? nullptr : new BufferPoolManager(buffer_pool_size, &disk_mgr);
+    auto read = [&](page_id_t page_id) {
+      if (bpm == nullptr) {
+        return *reinterpret_cast<const page_id_t *>(disk_mgr.GetPagePointer(page_id));
+      }
+      page_id_t value = *reinterpret_cast<page_id_t *>(bpm->FetchPage(page_id)->GetData());
+      bpm->UnpinPage(page_id, false);
+      return value;
+    };
+    size_t mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto page_id : lookups) {
+      mismatches += read(page_id) != page_id ? 1 : 0;
+    }
+    double lookup_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      mismatches += read(page_id) != page_id ? 1 : 0;
+    }
+    double scan_ms = elapsed_ms(start);
+    EXPECT_EQ(0, mismatches);
+    const char *names[] = {"buffer pool + pread", "buffer pool + mmap", "mmap in place"};
+    std::printf("%-20s: %zu point lookups %.2f ms (%.0f ns each), scan of %d pages %.2f ms\n", names[mode],
+                num_lookups, lookup_ms, lookup_ms * 1e6 / num_lookups, num_pages, scan_ms);
+    delete bpm;
+  }
+  remove(db_name.c_str());
+}
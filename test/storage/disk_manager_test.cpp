@@ -1,7 +1,18 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
 #include <unordered_set>
+#include <vector>
 
+#include "buffer/frame_arena.h"
 #include "gtest/gtest.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
@@ -56,4 +67,434 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, ReadPagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  // a run across the boundary of the first two extents, with its last page beyond the end of the file
+  const page_id_t first_page_id = DiskManager::BITMAP_SIZE - 2;
+  const size_t count = 4;
+  char data[PAGE_SIZE];
+  for (size_t i = 0; i < count - 1; i++) {
+    memset(data, 'a' + i, PAGE_SIZE);
+    disk_mgr->WritePage(first_page_id + i, data);
+  }
+  std::vector<char> buffer(count * PAGE_SIZE, 'x');
+  disk_mgr->ReadPages(first_page_id, count, buffer.data());
+  for (size_t i = 0; i < count; i++) {
+    disk_mgr->ReadPage(first_page_id + i, data);
+    EXPECT_EQ(0, memcmp(data, &buffer[i * PAGE_SIZE], PAGE_SIZE));
+    EXPECT_EQ(i < count - 1 ? 'a' + i : 0, buffer[i * PAGE_SIZE]);
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, FileGrowthTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto file_size = [&db_name]() {
+    struct stat stat_buf;
+    return stat(db_name.c_str(), &stat_buf) == 0 ? static_cast<size_t>(stat_buf.st_size) : 0;
+  };
+  const size_t chunk_size = DEFAULT_FILE_GROW_PAGES * PAGE_SIZE;
+  for (auto backend : {DiskIOBackend::FSTREAM, DiskIOBackend::POSITIONAL}) {
+    DiskManager *disk_mgr = new DiskManager(db_name, backend);
+    char data[PAGE_SIZE];
+    memset(data, 'x', PAGE_SIZE);
+    // Scenario: writing pages one after another grows the file a chunk at a time.
+    std::unordered_set<size_t> sizes;
+    for (page_id_t i = 0; i < 2 * DEFAULT_FILE_GROW_PAGES; i++) {
+      disk_mgr->WritePage(i, data);
+      sizes.insert(file_size());
+    }
+    EXPECT_EQ(3, sizes.size());
+    EXPECT_EQ(0, file_size() % chunk_size);
+    // Scenario: preallocated pages and pages beyond the end of the file read as zeros.
+    for (page_id_t page_id : {2 * DEFAULT_FILE_GROW_PAGES, 100 * DEFAULT_FILE_GROW_PAGES}) {
+      disk_mgr->ReadPage(page_id, data);
+      EXPECT_EQ(0, data[0]);
+      EXPECT_EQ(0, data[PAGE_SIZE - 1]);
+    }
+    disk_mgr->ReadPage(0, data);
+    EXPECT_EQ('x', data[0]);
+    disk_mgr->Close();
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
+
+TEST(DiskManagerTest, CachedBitmapTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  // Scenario: the word scan skips allocated pages and wraps around to the beginning of the extent.
+  char buf[PAGE_SIZE];
+  memset(buf, 0, PAGE_SIZE);
+  auto *bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(buf);
+  uint32_t ofs;
+  for (uint32_t i = 0; i < 130; i++) {
+    ASSERT_TRUE(bitmap->AllocatePage(ofs));
+    ASSERT_EQ(i, ofs);
+  }
+  EXPECT_EQ(130, bitmap->FindFreePage(0));
+  EXPECT_EQ(200, bitmap->FindFreePage(200));
+  ASSERT_TRUE(bitmap->DeAllocatePage(3));
+  EXPECT_EQ(3, bitmap->GetNextFreePage());
+  EXPECT_EQ(3, bitmap->FindFreePage(0));
+  EXPECT_EQ(130, bitmap->FindFreePage(4));
+  EXPECT_EQ(3, bitmap->FindFreePage(DiskManager::BITMAP_SIZE));
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  EXPECT_EQ(3, ofs);
+  EXPECT_EQ(130, bitmap->GetNextFreePage());
+
+  // Scenario: the cached bitmaps and the meta page are written back on close and read again on open.
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE + 10;
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->DeAllocatePage(5);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 1);
+  disk_mgr->Close();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages - 2, meta_page->GetAllocatedPages());
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_TRUE(disk_mgr->IsPageFree(5));
+  EXPECT_FALSE(disk_mgr->IsPageFree(6));
+  EXPECT_TRUE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 1));
+  EXPECT_TRUE(disk_mgr->IsPageFree(num_pages));
+  EXPECT_EQ(5, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 1, disk_mgr->AllocatePage());
+  EXPECT_EQ(num_pages, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AllocatePagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  for (page_id_t i = 0; i < 20; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  // holes of 2 and 4 pages
+  for (page_id_t page_id : {3, 4, 10, 11, 12, 13}) {
+    disk_mgr->DeAllocatePage(page_id);
+  }
+  // Scenario: a run takes the first hole that is long enough.
+  EXPECT_EQ(10, disk_mgr->AllocatePages(4));
+  EXPECT_EQ(20, disk_mgr->AllocatePages(3));
+  EXPECT_EQ(3, disk_mgr->AllocatePage());
+  EXPECT_EQ(22, meta_page->GetAllocatedPages());
+  // Scenario: a run that does not fit into the rest of an extent starts the next one.
+  page_id_t first_page_id = disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE - 10);
+  EXPECT_EQ(DiskManager::BITMAP_SIZE, first_page_id);
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 10, meta_page->GetExtentUsedPage(1));
+  EXPECT_FALSE(disk_mgr->IsPageFree(2 * DiskManager::BITMAP_SIZE - 11));
+  EXPECT_TRUE(disk_mgr->IsPageFree(2 * DiskManager::BITMAP_SIZE - 10));
+  // single pages still fill the first extent from its lowest free page
+  EXPECT_EQ(4, disk_mgr->AllocatePage());
+  EXPECT_EQ(23, disk_mgr->AllocatePage());
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr->AllocatePages(0));
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE + 1));
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, SparseScaleTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  // beyond the extents the meta page counts, into the third directory page: about 385 GB of pages
+  const uint32_t num_extents = META_PAGE_EXTENTS + 2 * DIRECTORY_PAGE_EXTENTS + 10;
+  const page_id_t num_pages = static_cast<page_id_t>(num_extents * DiskManager::BITMAP_SIZE);
+  const page_id_t far_page_ids[] = {0, static_cast<page_id_t>(META_PAGE_EXTENTS * DiskManager::BITMAP_SIZE),
+                                    num_pages / 2 + 7, num_pages - 1};
+  char data[PAGE_SIZE];
+  {
+    // a single file, opening it again without asking for one tells it from its size
+    DiskManager disk_mgr(db_name, DiskIOBackend::POSITIONAL, DurabilityMode::OS_BUFFERED, 0);
+    for (uint32_t extent_id = 0; extent_id < num_extents; extent_id++) {
+      ASSERT_EQ(static_cast<page_id_t>(extent_id * DiskManager::BITMAP_SIZE),
+                disk_mgr.AllocatePages(DiskManager::BITMAP_SIZE));
+    }
+    for (page_id_t page_id : far_page_ids) {
+      memset(data, 0, PAGE_SIZE);
+      *reinterpret_cast<page_id_t *>(data) = page_id;
+      disk_mgr.WritePage(page_id, data);
+    }
+    disk_mgr.DeAllocatePage(num_pages / 2);
+    disk_mgr.Close();
+  }
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  // the offsets of the last pages do not fit into 32 bits, yet the file takes a few MB on disk
+  EXPECT_GT(static_cast<size_t>(stat_buf.st_size), static_cast<size_t>(num_pages) * PAGE_SIZE);
+  EXPECT_LT(static_cast<size_t>(stat_buf.st_blocks) * 512, 64 * 1024 * 1024);
+
+  // Scenario: the directory pages survive a restart.
+  DiskManager disk_mgr(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr.GetMetaData());
+  EXPECT_EQ(static_cast<uint32_t>(num_pages - 1), meta_page->GetAllocatedPages());
+  for (page_id_t page_id : far_page_ids) {
+    EXPECT_FALSE(disk_mgr.IsPageFree(page_id));
+    disk_mgr.ReadPage(page_id, data);
+    EXPECT_EQ(page_id, *reinterpret_cast<page_id_t *>(data));
+  }
+  EXPECT_EQ(0, disk_mgr.GetSegmentPages());
+  EXPECT_EQ(num_pages / 2, disk_mgr.AllocatePage());
+  EXPECT_EQ(num_pages, disk_mgr.AllocatePage());
+  disk_mgr.Close();
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, SegmentTest) {
+  std::string db_name = "disk_test.db";
+  // the smallest segments, the first one holds the meta page, a bitmap page and the first data pages
+  const size_t segment_pages = DiskManager::BITMAP_SIZE;
+  const size_t count = 300;
+  const auto page_id_at = [&](size_t i) { return static_cast<page_id_t>(segment_pages - 2 - count / 2 + i); };
+  char data[PAGE_SIZE];
+  for (auto backend : {DiskIOBackend::POSITIONAL, DiskIOBackend::DIRECT}) {
+    DiskManager::RemoveDatabaseFiles(db_name);
+    std::vector<char> out(count * PAGE_SIZE);
+    {
+      DiskManager disk_mgr(db_name, backend, DurabilityMode::OS_BUFFERED, segment_pages);
+      EXPECT_EQ(segment_pages, disk_mgr.GetSegmentPages());
+      // the pages cross the end of the first segment, written by WritePage, WritePages and SubmitPageIO in turn
+      std::vector<std::pair<page_id_t, const char *>> pages;
+      std::vector<PageIORequest> requests;
+      std::atomic<size_t> completed{0};
+      for (size_t i = 0; i < count; i++) {
+        memset(&out[i * PAGE_SIZE], static_cast<int>(i % 251) + 1, PAGE_SIZE);
+        *reinterpret_cast<page_id_t *>(&out[i * PAGE_SIZE]) = page_id_at(i);
+        if (i % 3 == 0) {
+          disk_mgr.WritePage(page_id_at(i), &out[i * PAGE_SIZE]);
+        } else if (i % 3 == 1) {
+          pages.emplace_back(page_id_at(i), &out[i * PAGE_SIZE]);
+        } else {
+          requests.push_back({page_id_at(i), &out[i * PAGE_SIZE], true, [&completed]() { completed++; }});
+        }
+      }
+      disk_mgr.WritePages(pages);
+      disk_mgr.SubmitPageIO(std::move(requests));
+      disk_mgr.WaitForPageIO();
+      ASSERT_EQ(count / 3, completed);
+      std::vector<char> in(count * PAGE_SIZE, 'x');
+      disk_mgr.ReadPages(page_id_at(0), count, in.data());
+      EXPECT_EQ(0, memcmp(out.data(), in.data(), out.size()));
+      disk_mgr.Close();
+    }
+    EXPECT_TRUE(std::filesystem::exists(DiskManager::GetSegmentFileName(db_name, 1)));
+    EXPECT_FALSE(std::filesystem::exists(DiskManager::GetSegmentFileName(db_name, 2)));
+    // the first file is filled up, its size is the segment size when the database is opened again
+    EXPECT_EQ(segment_pages * PAGE_SIZE, std::filesystem::file_size(db_name));
+
+    // Scenario: a stream cannot span several files, positional I/O is used instead.
+    DiskManager disk_mgr(db_name, DiskIOBackend::FSTREAM);
+    EXPECT_EQ(segment_pages, disk_mgr.GetSegmentPages());
+    EXPECT_EQ(DiskIOBackend::POSITIONAL, disk_mgr.GetBackend());
+    for (size_t i = 0; i < count; i++) {
+      disk_mgr.ReadPage(page_id_at(i), data);
+      ASSERT_EQ(0, memcmp(data, &out[i * PAGE_SIZE], PAGE_SIZE));
+    }
+    disk_mgr.Close();
+  }
+
+  // Scenario: the space of freed pages goes back to the file system once the bitmap that frees them is synced.
+  const size_t num_pages = 1024;
+  DiskManager disk_mgr(db_name);
+  ASSERT_EQ(0, disk_mgr.AllocatePages(num_pages));
+  memset(data, 'a', PAGE_SIZE);
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_mgr.WritePage(static_cast<page_id_t>(i), data);
+  }
+  disk_mgr.Sync();
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  const size_t allocated_bytes = static_cast<size_t>(stat_buf.st_blocks) * 512;
+  // the last page is allocated again before the sync and keeps its space
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_mgr.DeAllocatePage(static_cast<page_id_t>(i));
+  }
+  ASSERT_EQ(0, disk_mgr.AllocatePage());
+  disk_mgr.Sync();
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  EXPECT_LE(static_cast<size_t>(stat_buf.st_blocks) * 512 + (num_pages - 1) * PAGE_SIZE, allocated_bytes);
+  disk_mgr.ReadPage(0, data);
+  EXPECT_EQ('a', data[PAGE_SIZE - 1]);
+  disk_mgr.Close();
+  DiskManager::RemoveDatabaseFiles(db_name);
+  EXPECT_FALSE(std::filesystem::exists(DiskManager::GetSegmentFileName(db_name, 1)));
+}
+
+TEST(DiskManagerTest, SubmitPageIOTest) {
+  std::string db_name = "disk_test.db";
+  const size_t count = 300;
+  // the buffers are not aligned, so with O_DIRECT the requests are carried out before SubmitPageIO returns
+  for (auto backend : {DiskIOBackend::FSTREAM, DiskIOBackend::POSITIONAL, DiskIOBackend::DIRECT}) {
+    for (auto type : {IOEngineType::THREAD_POOL, IOEngineType::IO_URING}) {
+      remove(db_name.c_str());
+      DiskManager disk_mgr(db_name, backend);
+      disk_mgr.SetIOEngine(type, 16);
+      EXPECT_EQ(backend == DiskIOBackend::FSTREAM, disk_mgr.GetIOEngine() == nullptr);
+      // the pages span the first two extents, the writes grow the file as they go
+      std::vector<char> out(count * PAGE_SIZE);
+      std::vector<PageIORequest> requests(count);
+      std::atomic<size_t> completed{0};
+      for (size_t i = 0; i < count; i++) {
+        page_id_t page_id = static_cast<page_id_t>(DiskManager::BITMAP_SIZE - count / 2 + i);
+        memset(&out[i * PAGE_SIZE], 0, PAGE_SIZE);
+        *reinterpret_cast<page_id_t *>(&out[i * PAGE_SIZE]) = page_id;
+        requests[i] = {page_id, &out[i * PAGE_SIZE], true, [&completed]() { completed++; }};
+      }
+      disk_mgr.SubmitPageIO(std::move(requests));
+      disk_mgr.WaitForPageIO();
+      ASSERT_EQ(count, completed);
+      char data[PAGE_SIZE];
+      for (size_t i = 0; i < count; i++) {
+        disk_mgr.ReadPage(static_cast<page_id_t>(DiskManager::BITMAP_SIZE - count / 2 + i), data);
+        ASSERT_EQ(0, memcmp(data, &out[i * PAGE_SIZE], PAGE_SIZE));
+      }
+      std::vector<char> in(count * PAGE_SIZE, 'x');
+      requests.assign(count, PageIORequest());
+      for (size_t i = 0; i < count; i++) {
+        requests[i] = {static_cast<page_id_t>(DiskManager::BITMAP_SIZE - count / 2 + i), &in[i * PAGE_SIZE], false,
+                       [&completed]() { completed++; }};
+      }
+      disk_mgr.SubmitPageIO(std::move(requests));
+      disk_mgr.WaitForPageIO();
+      ASSERT_EQ(2 * count, completed);
+      EXPECT_EQ(0, memcmp(out.data(), in.data(), out.size()));
+      disk_mgr.Close();
+    }
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, WritePagesTest) {
+  std::string db_name = "disk_test.db";
+  const size_t count = 300;
+  for (auto backend : {DiskIOBackend::FSTREAM, DiskIOBackend::POSITIONAL, DiskIOBackend::DIRECT}) {
+    remove(db_name.c_str());
+    DiskManager disk_mgr(db_name, backend);
+    // every other page of the first two extents, in reverse order, half of them from unaligned buffers
+    FrameArena aligned;
+    aligned.Grow(count);
+    std::vector<char> unaligned(count * PAGE_SIZE + 1);
+    std::vector<std::pair<page_id_t, const char *>> pages;
+    for (size_t i = 0; i < count; i++) {
+      page_id_t page_id = static_cast<page_id_t>(DiskManager::BITMAP_SIZE + count - 2 * i);
+      char *data = i % 4 < 2 ? aligned.GetFrame(i) : &unaligned[i * PAGE_SIZE + 1];
+      memset(data, static_cast<int>(i % 251) + 1, PAGE_SIZE);
+      *reinterpret_cast<page_id_t *>(data) = page_id;
+      pages.emplace_back(page_id, data);
+    }
+    disk_mgr.WritePages(pages);
+    char data[PAGE_SIZE];
+    for (auto &[page_id, page_data] : pages) {
+      disk_mgr.ReadPage(page_id, data);
+      ASSERT_EQ(0, memcmp(data, page_data, PAGE_SIZE));
+      // the pages in between were never written
+      disk_mgr.ReadPage(page_id + 1, data);
+      ASSERT_EQ(std::vector<char>(PAGE_SIZE, 0), std::vector<char>(data, data + PAGE_SIZE));
+    }
+    disk_mgr.Close();
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, DirectIOTest) {
+  std::string db_name = "disk_test.db";
+  const page_id_t num_pages = 64;
+  remove(db_name.c_str());
+  {
+    DiskManager disk_mgr(db_name, DiskIOBackend::DIRECT);
+    ASSERT_EQ(DiskIOBackend::DIRECT, disk_mgr.GetBackend());
+    FrameArena aligned;
+    aligned.Grow(num_pages);
+    std::vector<PageIORequest> requests;
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr.AllocatePage());
+      *reinterpret_cast<page_id_t *>(aligned.GetFrame(i)) = i;
+      if (i % 2 == 0) {
+        disk_mgr.WritePage(i, aligned.GetFrame(i));
+      } else {
+        requests.push_back({i, aligned.GetFrame(i), true, nullptr});
+      }
+    }
+    disk_mgr.SubmitPageIO(std::move(requests));
+    disk_mgr.WaitForPageIO();
+    // an unaligned buffer goes through an aligned copy
+    char data[PAGE_SIZE + 1];
+    disk_mgr.ReadPage(num_pages - 1, data + 1);
+    EXPECT_EQ(0, memcmp(aligned.GetFrame(num_pages - 1), data + 1, PAGE_SIZE));
+    data[1] = 'x';
+    disk_mgr.WritePage(num_pages - 1, data + 1);
+    disk_mgr.Close();
+  }
+  // nothing written went through the OS page cache
+  int fd = open(db_name.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  size_t file_size = lseek(fd, 0, SEEK_END);
+  void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  ASSERT_NE(MAP_FAILED, mapping);
+  std::vector<unsigned char> resident((file_size + PAGE_SIZE - 1) / PAGE_SIZE);
+  ASSERT_EQ(0, mincore(mapping, file_size, resident.data()));
+  EXPECT_EQ(0, std::count_if(resident.begin(), resident.end(), [](unsigned char page) { return page & 1; }));
+  munmap(mapping, file_size);
+  close(fd);
+
+  DiskManager disk_mgr(db_name);
+  char data[PAGE_SIZE];
+  for (page_id_t i = 0; i < num_pages; i++) {
+    ASSERT_FALSE(disk_mgr.IsPageFree(i));
+    disk_mgr.ReadPage(i, data);
+    EXPECT_EQ(i == num_pages - 1 ? 'x' : i, data[0]);
+  }
+  disk_mgr.Close();
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, MmapReadOnlyTest) {
+  std::string db_name = "disk_test.db";
+  // the pages span three extents, so the mapping has to skip the interleaved bitmap pages
+  const page_id_t num_pages = 2 * DiskManager::BITMAP_SIZE + 10;
+  remove(db_name.c_str());
+  {
+    DiskManager disk_mgr(db_name);
+    char data[PAGE_SIZE];
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr.AllocatePage());
+      memset(data, 0, PAGE_SIZE);
+      *reinterpret_cast<page_id_t *>(data) = i;
+      disk_mgr.WritePage(i, data);
+    }
+  }
+  DiskManager disk_mgr(db_name, DiskIOBackend::MMAP);
+  char data[PAGE_SIZE];
+  for (page_id_t i = 0; i < num_pages; i++) {
+    const char *page = disk_mgr.GetPagePointer(i);
+    ASSERT_EQ(i, *reinterpret_cast<const page_id_t *>(page));
+    disk_mgr.ReadPage(i, data);
+    ASSERT_EQ(0, memcmp(page, data, PAGE_SIZE));
+    ASSERT_FALSE(disk_mgr.IsPageFree(i));
+  }
+  // pages beyond the end of the file read as zeros
+  const page_id_t beyond = 100 * DiskManager::BITMAP_SIZE;
+  EXPECT_EQ(std::string(PAGE_SIZE, '\0'), std::string(disk_mgr.GetPagePointer(beyond), PAGE_SIZE));
+  // the database cannot change, but writing back an unmodified page is harmless
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr.AllocatePage());
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr.AllocatePages(4));
+  disk_mgr.ReadPage(5, data);
+  disk_mgr.WritePage(5, data);
+  disk_mgr.Close();
+  remove(db_name.c_str());
+}
@@ -0,0 +1,121 @@
+#include "storage/io_engine.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+const std::string file_name = "io_engine_test.db";
+}  // namespace
+
+TEST(IOEngineTest, ReadWriteTest) {
+  const size_t num_pages = 256;
+  for (auto type : {IOEngineType::THREAD_POOL, IOEngineType::IO_URING}) {
+    remove(file_name.c_str());
+    int fd = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+    {
+      // a queue shallower than the batch makes Submit wait for completions
+      auto engine = IOEngine::Create(fd, type, 8);
+      std::vector<char> out(num_pages * PAGE_SIZE);
+      std::vector<IORequest> requests(num_pages);
+      std::atomic<size_t> completed{0};
+      for (size_t i = 0; i < num_pages; i++) {
+        memset(&out[i * PAGE_SIZE], static_cast<int>(i % 251) + 1, PAGE_SIZE);
+        requests[i].write_ = true;
+        requests[i].offset_ = i * PAGE_SIZE;
+        requests[i].data_ = &out[i * PAGE_SIZE];
+        requests[i].size_ = PAGE_SIZE;
+        requests[i].callback_ = [&completed](bool ok) { completed += ok ? 1 : 0; };
+      }
+      engine->Submit(std::move(requests));
+      engine->Drain();
+      ASSERT_EQ(num_pages, completed);
+
+      // read everything back in reverse order, plus one page beyond the end of the file
+      std::vector<char> in((num_pages + 1) * PAGE_SIZE, 'x');
+      requests.assign(num_pages + 1, IORequest());
+      for (size_t i = 0; i <= num_pages; i++) {
+        size_t page = num_pages - i;
+        requests[i].offset_ = page * PAGE_SIZE;
+        requests[i].data_ = &in[page * PAGE_SIZE];
+        requests[i].size_ = PAGE_SIZE;
+        requests[i].callback_ = [&completed](bool ok) { completed += ok ? 1 : 0; };
+      }
+      engine->Submit(std::move(requests));
+      engine->Drain();
+      ASSERT_EQ(2 * num_pages + 1, completed);
+      EXPECT_EQ(0, memcmp(out.data(), in.data(), out.size()));
+      EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), std::vector<char>(in.end() - PAGE_SIZE, in.end()));
+    }
+    close(fd);
+  }
+  remove(file_name.c_str());
+}
+
+TEST(IOEngineTest, VectoredBatchTest) {
+  const size_t num_runs = 16;
+  const size_t run_pages = 8;
+  for (auto type : {IOEngineType::THREAD_POOL, IOEngineType::IO_URING}) {
+    remove(file_name.c_str());
+    int fd = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+    {
+      auto engine = IOEngine::Create(fd, type, 4);
+      // each run scatters its pages over the buffer in reverse, so that a request that ignored its iovecs is caught
+      std::vector<char> out(num_runs * run_pages * PAGE_SIZE);
+      std::vector<IORequest> requests(num_runs);
+      IOBatch batch;
+      for (size_t i = 0; i < num_runs * run_pages; i++) {
+        memset(&out[i * PAGE_SIZE], static_cast<int>(i % 251) + 1, PAGE_SIZE);
+      }
+      for (size_t run = 0; run < num_runs; run++) {
+        requests[run].write_ = true;
+        requests[run].offset_ = run * run_pages * PAGE_SIZE;
+        requests[run].size_ = run_pages * PAGE_SIZE;
+        for (size_t i = 0; i < run_pages; i++) {
+          requests[run].iov_.push_back({&out[(run * run_pages + run_pages - 1 - i) * PAGE_SIZE], PAGE_SIZE});
+        }
+        requests[run].callback_ = [&batch](bool ok) {
+          EXPECT_TRUE(ok);
+          batch.Done();
+        };
+      }
+      batch.Add(num_runs);
+      engine->Submit(std::move(requests));
+      batch.Wait();
+
+      // read all pages back with one vectored request that reaches a run beyond the end of the file
+      std::vector<char> in((num_runs + 1) * run_pages * PAGE_SIZE, 'x');
+      requests.assign(1, IORequest());
+      requests[0].size_ = in.size();
+      for (size_t i = 0; i < (num_runs + 1) * run_pages; i++) {
+        requests[0].iov_.push_back({&in[i * PAGE_SIZE], PAGE_SIZE});
+      }
+      requests[0].callback_ = [&batch](bool ok) {
+        EXPECT_TRUE(ok);
+        batch.Done();
+      };
+      batch.Add(1);
+      engine->Submit(std::move(requests));
+      batch.Wait();
+      for (size_t run = 0; run < num_runs; run++) {
+        for (size_t i = 0; i < run_pages; i++) {
+          ASSERT_EQ(0, memcmp(&in[(run * run_pages + i) * PAGE_SIZE],
+                              &out[(run * run_pages + run_pages - 1 - i) * PAGE_SIZE], PAGE_SIZE));
+        }
+      }
+      EXPECT_EQ(std::vector<char>(run_pages * PAGE_SIZE, 0),
+                std::vector<char>(in.end() - run_pages * PAGE_SIZE, in.end()));
+    }
+    close(fd);
+  }
+  remove(file_name.c_str());
+}
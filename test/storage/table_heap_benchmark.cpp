@@ -0,0 +1,180 @@
+#include "storage/table_heap.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+static string db_file_name = "table_heap_benchmark.db";
+using Fields = std::vector<Field>;
+
+/**
+ * Benchmark: insert throughput of a table heap under each durability mode. The buffer pool is small, so most pages are
+ * written back while the inserts run, and every new page allocates on disk.
+ */
+TEST(TableHeapBenchmark, DurabilityModeInsertBenchmark) {
+  const int row_nums = 5000;
+  const size_t buffer_pool_size = 16;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  const std::pair<DurabilityMode, const char *> modes[] = {{DurabilityMode::SYNC_EVERY_WRITE, "sync_every_write"},
+                                                           {DurabilityMode::GROUP_COMMIT, "group_commit"},
+                                                           {DurabilityMode::OS_BUFFERED, "os_buffered"}};
+  for (auto &mode : modes) {
+    remove(db_file_name.c_str());
+    auto disk_mgr = new DiskManager(db_file_name, DiskIOBackend::POSITIONAL, mode.first);
+    auto bpm = new BufferPoolManager(buffer_pool_size, disk_mgr);
+    auto start = std::chrono::steady_clock::now();
+    TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    delete table_heap;
+    // the inserts are durable once the pool is flushed and the disk manager synced
+    delete bpm;
+    disk_mgr->Close();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %d rows in %.2f ms, %.0f rows/s\n", mode.second, row_nums, elapsed_ms,
+                row_nums / elapsed_ms * 1000);
+    delete disk_mgr;
+  }
+  remove(db_file_name.c_str());
+}
+
+/**
+ * Benchmark: the cost of an insert as the table grows. Inserts look the page up in the free space map instead of
+ * walking the page list, so the cost per row stays flat.
+ */
+TEST(TableHeapBenchmark, InsertScalingBenchmark) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name, DiskIOBackend::POSITIONAL, DurabilityMode::OS_BUFFERED);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  int rows = 0;
+  for (int target : {1000, 10000, 100000, 1000000}) {
+    auto start = std::chrono::steady_clock::now();
+    const int batch = target - rows;
+    for (; rows < target; rows++) {
+      Fields fields{Field(TypeId::kTypeInt, rows), Field(TypeId::kTypeChar, name, 64, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%8d rows: %.2f us per insert\n", target, elapsed_us / batch);
+  }
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+/**
+ * Benchmark: loading rows one InsertTuple at a time against one BulkInsert.
+ */
+TEST(TableHeapBenchmark, BulkInsertBenchmark) {
+  const int row_nums = 200000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  for (bool bulk : {false, true}) {
+    remove(db_file_name.c_str());
+    auto disk_mgr = new DiskManager(db_file_name, DiskIOBackend::POSITIONAL, DurabilityMode::OS_BUFFERED);
+    auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+    std::vector<Row> rows;
+    rows.reserve(row_nums);
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+      rows.emplace_back(fields);
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (bulk) {
+      ASSERT_TRUE(table_heap->BulkInsert(rows, nullptr));
+    } else {
+      for (auto &row : rows) {
+        ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      }
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %d rows in %.2f ms, %.0f rows/s\n", bulk ? "BulkInsert " : "InsertTuple", row_nums, elapsed_ms,
+                row_nums / elapsed_ms * 1000);
+    delete table_heap;
+    delete bpm;
+    delete disk_mgr;
+  }
+  remove(db_file_name.c_str());
+}
+
+/**
+ * Benchmark: a full scan through TableIterator against the page-at-a-time TableBatchIterator.
+ */
+TEST(TableHeapBenchmark, ScanBenchmark) {
+  remove(db_file_name.c_str());
+  const int row_nums = 200000;
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<Row> rows;
+  rows.reserve(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    rows.emplace_back(fields);
+  }
+  ASSERT_TRUE(table_heap->BulkInsert(rows, nullptr));
+  for (bool batch : {false, true}) {
+    BufferPoolStats before = bpm->GetStats();
+    auto start = std::chrono::steady_clock::now();
+    // touch a field of every row, as a filter would
+    Field half(TypeId::kTypeInt, row_nums / 2);
+    int matched = 0;
+    int count = 0;
+    if (batch) {
+      auto iter = table_heap->BeginBatch();
+      while (iter.NextBatch()) {
+        for (size_t i = 0; i < iter.GetBatchSize(); i++) {
+          matched += iter.GetRow(i).GetField(0)->CompareLessThan(half) == CmpBool::kTrue;
+          count++;
+        }
+      }
+    } else {
+      for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+        matched += iter->GetField(0)->CompareLessThan(half) == CmpBool::kTrue;
+        count++;
+      }
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BufferPoolStats after = bpm->GetStats();
+    uint64_t fetches = after.hits_ + after.misses_ - before.hits_ - before.misses_;
+    ASSERT_EQ(row_nums, count);
+    ASSERT_EQ(row_nums / 2, matched);
+    std::printf("%s: %d rows in %.2f ms, %.0f rows/s, %.3f page fetches per row\n",
+                batch ? "TableBatchIterator" : "TableIterator     ", row_nums, elapsed_ms, row_nums / elapsed_ms * 1000,
+                static_cast<double>(fetches) / row_nums);
+  }
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
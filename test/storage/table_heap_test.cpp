@@ -1,5 +1,7 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <unordered_map>
 #include <vector>
 
@@ -60,3 +62,289 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, ExtentGrowthTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(64, disk_mgr);
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  // two heaps growing at the same time, one page at a time they would interleave page by page
+  TableHeap *table_heaps[] = {TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr),
+                              TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr)};
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heaps[i % 2]->InsertTuple(row, nullptr));
+  }
+  for (auto table_heap : table_heaps) {
+    int pages = 0;
+    int jumps = 0;
+    for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+      auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+      page_id_t next_page_id = page->GetNextPageId();
+      if (next_page_id != INVALID_PAGE_ID && next_page_id != page_id + 1) {
+        jumps++;
+      }
+      // the runs a scan reads ahead as ranges are exactly those of the page list
+      EXPECT_EQ(next_page_id == page_id + 1 ? 1 : 0, table_heap->GetContiguousPages(page_id, 1));
+      bpm->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    // the heap grows by runs that get longer as it grows
+    EXPECT_GT(pages, 100);
+    EXPECT_LT(jumps, pages / 8);
+    int rows = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+      int id = 2 * rows + (table_heap == table_heaps[0] ? 0 : 1);
+      ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+      rows++;
+    }
+    EXPECT_EQ(row_nums / 2, rows);
+    delete table_heap;
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(64, disk_mgr);
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  const page_id_t first_page_id = table_heap->GetFirstPageId();
+  const page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+  ASSERT_NE(INVALID_PAGE_ID, fsm_page_id);
+  // the rows deleted from a page far from the end make room there for the next inserts
+  auto delete_page = [&](page_id_t page_id) {
+    int deleted = 0;
+    for (auto &rid : rids) {
+      if (rid.GetPageId() == page_id) {
+        ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+        table_heap->ApplyDelete(rid, nullptr);
+        deleted++;
+      }
+    }
+    ASSERT_GT(deleted, 2);
+  };
+  const page_id_t middle_page_id = rids[row_nums / 2].GetPageId();
+  delete_page(middle_page_id);
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, name, 64, true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(middle_page_id, row.GetRowId().GetPageId());
+  delete table_heap;
+
+  // the map is persistent, a heap opened with it finds the room left
+  table_heap = TableHeap::Create(bpm, first_page_id, schema.get(), nullptr, nullptr, fsm_page_id);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(middle_page_id, row.GetRowId().GetPageId());
+  delete_page(first_page_id);
+  delete table_heap;
+
+  // a heap opened without its map builds one from its pages
+  table_heap = TableHeap::Create(bpm, first_page_id, schema.get(), nullptr, nullptr);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(first_page_id, row.GetRowId().GetPageId());
+  EXPECT_NE(fsm_page_id, table_heap->GetFreeSpaceMapPageId());
+  delete table_heap;
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, FreeSpaceMapNoPageTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(16, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  for (int i = 0; i < 200; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  const page_id_t first_page_id = table_heap->GetFirstPageId();
+  delete table_heap;
+  std::vector<page_id_t> heap_page_ids;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+    heap_page_ids.push_back(page_id);
+    page_id = page->GetNextPageId();
+  }
+  ASSERT_GT(heap_page_ids.size(), 2);
+  // every frame pinned, the heap opened without its map can read its pages but gets no page to build the map on
+  std::vector<page_id_t> filler_page_ids;
+  page_id_t filler_page_id;
+  while (bpm->NewPage(filler_page_id) != nullptr) {
+    filler_page_ids.push_back(filler_page_id);
+  }
+  table_heap = TableHeap::Create(bpm, first_page_id, schema.get(), nullptr, nullptr);
+  Fields fields{Field(TypeId::kTypeInt, 200), Field(TypeId::kTypeChar, name, 64, true)};
+  Row row(fields);
+  EXPECT_FALSE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(INVALID_PAGE_ID, table_heap->GetFreeSpaceMapPageId());
+  for (auto page_id : filler_page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    ASSERT_TRUE(bpm->DeletePage(page_id));
+  }
+  for (auto page_id : heap_page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  // once there is room the map is built with an entry for every page
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  std::vector<page_id_t> fsm_page_ids;
+  table_heap->GetFreeSpaceMapPageIds(&fsm_page_ids);
+  ASSERT_EQ(1, fsm_page_ids.size());
+  auto fsm_page = reinterpret_cast<FreeSpaceMapPage *>(bpm->FetchPage(fsm_page_ids[0])->GetData());
+  EXPECT_LE(heap_page_ids.size(), fsm_page->GetEntryCount());
+  for (size_t i = 0; i < heap_page_ids.size(); i++) {
+    EXPECT_EQ(heap_page_ids[i], fsm_page->GetPageIdAt(i));
+  }
+  bpm->UnpinPage(fsm_page_ids[0], false);
+  delete table_heap;
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, BulkInsertTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(64, disk_mgr);
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  Fields first_fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, name, 64, true)};
+  Row first_row(first_fields);
+  ASSERT_TRUE(table_heap->InsertTuple(first_row, nullptr));
+  std::vector<Row> rows;
+  for (int i = 1; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    rows.emplace_back(fields);
+  }
+  ASSERT_TRUE(table_heap->BulkInsert(rows, nullptr));
+  // the rows follow the first one in order, on fresh pages allocated in runs
+  int pages = 0;
+  int jumps = 0;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID && next_page_id != page_id + 1) {
+      jumps++;
+    }
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  EXPECT_LT(jumps, pages / 8);
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, count)));
+    if (count > 0) {
+      ASSERT_EQ(rows[count - 1].GetRowId().Get(), iter->GetRowId().Get());
+    }
+    count++;
+  }
+  EXPECT_EQ(row_nums, count);
+  // the room left on the first page is still found by the next insert
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, name, 64, true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(table_heap->GetFirstPageId(), row.GetRowId().GetPageId());
+  delete table_heap;
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, BatchScanTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(64, disk_mgr);
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // every third row, and all rows of the second page, so a batch has gaps and a page has none to read
+  page_id_t second_page_id = rids[0].GetPageId();
+  for (auto &rid : rids) {
+    if (rid.GetPageId() != second_page_id) {
+      second_page_id = rid.GetPageId();
+      break;
+    }
+  }
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 3 == 0 || rids[i].GetPageId() == second_page_id) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      table_heap->ApplyDelete(rids[i], nullptr);
+    }
+  }
+  std::vector<RowId> expected;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    expected.push_back(iter->GetRowId());
+  }
+  ASSERT_LT(0, expected.size());
+  size_t count = 0;
+  auto batch_iter = table_heap->BeginBatch();
+  while (batch_iter.NextBatch()) {
+    page_id_t page_id = batch_iter.GetRow(0).GetRowId().GetPageId();
+    ASSERT_NE(second_page_id, page_id);
+    for (size_t i = 0; i < batch_iter.GetBatchSize(); i++) {
+      Row &row = batch_iter.GetRow(i);
+      ASSERT_EQ(page_id, row.GetRowId().GetPageId());
+      ASSERT_EQ(expected[count].Get(), row.GetRowId().Get());
+      int id = std::find(rids.begin(), rids.end(), row.GetRowId()) - rids.begin();
+      ASSERT_EQ(2, row.GetFieldCount());
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+      count++;
+    }
+  }
+  EXPECT_EQ(expected.size(), count);
+  EXPECT_FALSE(batch_iter.NextBatch());
+  EXPECT_EQ(0, batch_iter.GetBatchSize());
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}